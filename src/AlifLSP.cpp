@@ -1,12 +1,108 @@
 #include "Server.h"
+#include "ListenServer.h"
 
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#if !defined(_WIN32)
+#include <csignal>
+#endif
 
-int main() {
+// Parse a positive integer option of the form --flag=<value>
+static bool parseSizeOption(const std::string& arg, const std::string& flag, size_t& value, bool& matched) {
+	matched = arg.rfind(flag, 0) == 0;
+	if (!matched) {
+		return true;
+	}
+	char* end = nullptr;
+	unsigned long long parsed = std::strtoull(arg.c_str() + flag.size(), &end, 10);
+	if (end == arg.c_str() + flag.size() || *end != '\0' || parsed == 0) {
+		Logger::error("Invalid value for " + flag.substr(0, flag.size() - 1) + ": " + arg.substr(flag.size()));
+		return false;
+	}
+	value = static_cast<size_t>(parsed);
+	return true;
+}
+
+// Parse command line options; returns false on invalid usage
+static bool parseArguments(int argc, char* argv[], ServerOptions& options) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool matched = false;
+		if (!parseSizeOption(arg, "--max-message-size=", options.maxMessageSize, matched)) {
+			return false;
+		}
+		if (matched) {
+			continue;
+		}
+		if (!parseSizeOption(arg, "--threads=", options.workerThreads, matched)) {
+			return false;
+		}
+		if (matched) {
+			continue;
+		}
+
+		if (arg == "--stdio") {
+			// The default transport, accepted for editor compatibility
+		}
+		else if (arg.rfind("--listen=", 0) == 0) {
+			ListenAddress address;
+			options.listenAddress = arg.substr(9);
+			if (!ListenAddress::parse(options.listenAddress, address)) {
+				Logger::error("Invalid listen address: " + options.listenAddress);
+				return false;
+			}
+		}
+		else if (arg == "--index-workspace") {
+			options.indexWorkspace = true;
+		}
+		else if (arg.rfind("--record=", 0) == 0 && arg.size() > 9) {
+			options.recordFile = arg.substr(9);
+		}
+		else if (arg == "--record" && i + 1 < argc) {
+			options.recordFile = argv[++i];
+		}
+		else {
+			Logger::error("Unknown option: " + arg);
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
 	// Disable stdio buffering
 	setvbuf(stdin, nullptr, _IONBF, 0);
 	setvbuf(stdout, nullptr, _IONBF, 0);
 
-	LSPServer server{};
+#if !defined(_WIN32)
+	// Report a closed editor pipe as EPIPE instead of killing the process
+	std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+	ServerOptions options{};
+	if (!parseArguments(argc, argv, options)) {
+		std::cerr << "Usage: alif-lsp [--stdio | --listen=unix:<path> | --listen=tcp:<port>]"
+			" [--max-message-size=<bytes>] [--threads=<count>] [--record=<file>] [--index-workspace]" << std::endl;
+		return 2;
+	}
+
+	// Recordings capture a single editor session, so they need the stdio transport
+	if (!options.recordFile.empty() && !options.listenAddress.empty()) {
+		Logger::error("--record cannot be combined with --listen");
+		return 2;
+	}
+
+	// Serve editor connections from one long-lived process
+	// The shared long-lived server always indexes; a single stdio session opts in
+	if (!options.listenAddress.empty()) {
+		options.indexWorkspace = true;
+		ListenAddress address;
+		ListenAddress::parse(options.listenAddress, address);
+		ListenServer server{ options, address };
+		return server.run();
+	}
+
+	LSPServer server{ options };
 	return server.run();
 }
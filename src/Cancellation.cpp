@@ -0,0 +1,59 @@
+#include "Cancellation.h"
+
+
+const CancellationToken& CancellationToken::none() {
+	static const CancellationToken token{};
+	return token;
+}
+
+CancellationToken RequestTable::add(const json& id) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto [it, inserted] = requests.try_emplace(key(id));
+	return it->second;
+}
+
+bool RequestTable::cancel(const json& id) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = requests.find(key(id));
+	if (it == requests.end()) {
+		return false;
+	}
+	it->second.cancel();
+	return true;
+}
+
+CancellationToken RequestTable::find(const json& id) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = requests.find(key(id));
+	if (it == requests.end()) {
+		return CancellationToken{};
+	}
+	return it->second;
+}
+
+void RequestTable::remove(const json& id) {
+	std::lock_guard<std::mutex> lock(mutex);
+	requests.erase(key(id));
+}
+
+bool RequestTable::claim(const json& id) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return requests.erase(key(id)) > 0;
+}
+
+bool RequestTable::contains(const json& id) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return requests.find(key(id)) != requests.end();
+}
+
+void RequestTable::cancelAll() {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto& [key, token] : requests) {
+		token.cancel();
+	}
+}
+
+size_t RequestTable::size() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return requests.size();
+}
@@ -0,0 +1,320 @@
+#include "ChangeTextScanner.h"
+#include "JsonString.h"
+
+#include <cstring>
+#include <utility>
+
+
+ChangeTextScanner::ChangeTextScanner(std::vector<std::string_view> segments, ChangeTexts& result)
+	: segments(std::move(segments)), result(result) {}
+
+bool ChangeTextScanner::extract(const MessageBody& body, ChangeTexts& result) {
+	std::vector<std::string_view> segments;
+	if (body.chunked) {
+		segments.reserve(body.chunks.segmentCount());
+		for (size_t i = 0; i < body.chunks.segmentCount(); ++i) {
+			segments.push_back(body.chunks.segment(i));
+		}
+	}
+	else {
+		segments.push_back(body.data);
+	}
+
+	result.skeleton.clear();
+	result.texts.clear();
+	ChangeTextScanner scanner(std::move(segments), result);
+	return scanner.scanMessage();
+}
+
+bool ChangeTextScanner::restore(json& message, std::vector<std::string>& texts) {
+	auto params = message.find("params");
+	if (params == message.end()) {
+		return false;
+	}
+	auto changes = params->find("contentChanges");
+	if (changes == params->end() || !changes->is_array() || changes->size() != texts.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < texts.size(); ++i) {
+		json& change = (*changes)[i];
+		auto text = change.find("text");
+		if (text == change.end() || !text->is_string()) {
+			return false;
+		}
+		text->get_ref<std::string&>() = std::move(texts[i]);
+	}
+	return true;
+}
+
+bool ChangeTextScanner::atEnd() {
+	while (segment < segments.size() && pos == segments[segment].size()) {
+		++segment;
+		pos = 0;
+	}
+	return segment == segments.size();
+}
+
+char ChangeTextScanner::peek() {
+	return segments[segment][pos];
+}
+
+void ChangeTextScanner::advance() {
+	result.skeleton.push_back(segments[segment][pos]);
+	++pos;
+}
+
+void ChangeTextScanner::skipWhitespace() {
+	while (!atEnd()) {
+		char c = peek();
+		if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+			return;
+		}
+		advance();
+	}
+}
+
+bool ChangeTextScanner::expect(char c) {
+	if (atEnd() || peek() != c) {
+		return false;
+	}
+	advance();
+	return true;
+}
+
+bool ChangeTextScanner::scanString(std::string* decoded, bool copy) {
+	if (!expect('"')) {
+		return false;
+	}
+	JsonStringDecoder decoder(decoded);
+	while (!atEnd()) {
+		std::string_view rest = segments[segment].substr(pos);
+		size_t consumed = 0;
+		JsonStringDecoder::Status status = decoder.feed(rest, consumed);
+		if (copy) {
+			result.skeleton.append(rest.data(), consumed);
+		}
+		pos += consumed;
+		if (status == JsonStringDecoder::Status::DONE) {
+			if (!copy) {
+				result.skeleton.push_back('"');
+			}
+			return true;
+		}
+		if (status == JsonStringDecoder::Status::INVALID) {
+			return false;
+		}
+	}
+	return false;
+}
+
+size_t ChangeTextScanner::quotedLength() {
+	size_t length = 0;
+	// الشرطات المائلة المتتالية في نهاية ما سبق من الكتل
+	size_t trailing = 0;
+	size_t from = pos + 1;
+	for (size_t i = segment; i < segments.size(); ++i, from = 0) {
+		std::string_view view = segments[i];
+		size_t start = from;
+		while (start < view.size()) {
+			const void* found = std::memchr(view.data() + start, '"', view.size() - start);
+			if (!found) {
+				break;
+			}
+			size_t quote = static_cast<const char*>(found) - view.data();
+			// علامة التنصيص مهرّبة إن سبقها عدد فردي من الشرطات المائلة
+			size_t run = 0;
+			while (quote - run > from && view[quote - run - 1] == '\\') {
+				++run;
+			}
+			if (quote - run == from) {
+				run += trailing;
+			}
+			if (run % 2 == 0) {
+				return length + quote - from;
+			}
+			start = quote + 1;
+		}
+		size_t run = 0;
+		while (run < view.size() - from && view[view.size() - run - 1] == '\\') {
+			++run;
+		}
+		trailing = run == view.size() - from ? trailing + run : run;
+		length += view.size() - from;
+	}
+	return length;
+}
+
+bool ChangeTextScanner::skipValue() {
+	if (atEnd()) {
+		return false;
+	}
+	char c = peek();
+	if (c == '"') {
+		return scanString(nullptr, true);
+	}
+	if (c == '{' || c == '[') {
+		// عد الأقواس فقط؛ التحقق من البنية يتم عند تحليل skeleton
+		int depth = 0;
+		while (!atEnd()) {
+			c = peek();
+			if (c == '"') {
+				if (!scanString(nullptr, true)) {
+					return false;
+				}
+				continue;
+			}
+			advance();
+			if (c == '{' || c == '[') {
+				++depth;
+			}
+			else if ((c == '}' || c == ']') && --depth == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+	// عدد أو true/false/null: حتى الفاصل التالي
+	size_t start = result.skeleton.size();
+	while (!atEnd()) {
+		c = peek();
+		if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+			break;
+		}
+		advance();
+	}
+	return result.skeleton.size() > start;
+}
+
+template <typename Member>
+bool ChangeTextScanner::scanObject(Member&& member) {
+	skipWhitespace();
+	if (!expect('{')) {
+		return false;
+	}
+	skipWhitespace();
+	if (!atEnd() && peek() == '}') {
+		advance();
+		return true;
+	}
+
+	std::string key;
+	while (true) {
+		skipWhitespace();
+		key.clear();
+		if (!scanString(&key, true)) {
+			return false;
+		}
+		skipWhitespace();
+		if (!expect(':')) {
+			return false;
+		}
+		skipWhitespace();
+		if (!member(key)) {
+			return false;
+		}
+		skipWhitespace();
+		if (atEnd()) {
+			return false;
+		}
+		if (peek() == '}') {
+			advance();
+			return true;
+		}
+		if (!expect(',')) {
+			return false;
+		}
+	}
+}
+
+bool ChangeTextScanner::scanMessage() {
+	result.skeleton.reserve(256);
+	bool isChange = false;
+	bool hasParams = false;
+	bool hasChanges = false;
+
+	bool valid = scanObject([&](const std::string& key) {
+		if (key == "method") {
+			std::string method;
+			if (atEnd() || peek() != '"' || !scanString(&method, true)) {
+				return false;
+			}
+			// رسالة أخرى (مثل didOpen بنص كبير): التوقف قبل المرور على params
+			isChange = method == "textDocument/didChange";
+			return isChange;
+		}
+		if (key == "params") {
+			// المفاتيح المكررة يحسمها المحلل الكامل
+			if (hasParams) {
+				return false;
+			}
+			hasParams = true;
+			return scanParams(hasChanges);
+		}
+		return skipValue();
+	});
+
+	skipWhitespace();
+	return valid && atEnd() && isChange && hasChanges;
+}
+
+bool ChangeTextScanner::scanParams(bool& hasChanges) {
+	if (atEnd() || peek() != '{') {
+		return false;
+	}
+	return scanObject([&](const std::string& key) {
+		if (key != "contentChanges") {
+			return skipValue();
+		}
+		if (hasChanges) {
+			return false;
+		}
+		hasChanges = true;
+		return scanChanges();
+	});
+}
+
+bool ChangeTextScanner::scanChanges() {
+	if (!expect('[')) {
+		return false;
+	}
+	skipWhitespace();
+	if (!atEnd() && peek() == ']') {
+		advance();
+		return true;
+	}
+
+	while (true) {
+		if (!scanChange()) {
+			return false;
+		}
+		skipWhitespace();
+		if (atEnd()) {
+			return false;
+		}
+		if (peek() == ']') {
+			advance();
+			return true;
+		}
+		if (!expect(',')) {
+			return false;
+		}
+	}
+}
+
+bool ChangeTextScanner::scanChange() {
+	bool hasText = false;
+	bool valid = scanObject([&](const std::string& key) {
+		if (key != "text") {
+			return skipValue();
+		}
+		if (hasText || atEnd() || peek() != '"') {
+			return false;
+		}
+		hasText = true;
+		// طول النص المرمّز حد أعلى للنص المفكوك: تخصيص واحد بحجم هذا التعديل دون إعادة نسخ
+		std::string& text = result.texts.emplace_back();
+		text.reserve(quotedLength());
+		return scanString(&text, false) && JsonStringDecoder::isValidUtf8(text);
+	});
+	return valid && hasText;
+}
@@ -1,23 +1,64 @@
 #include "Completion.h"
-#include "DocManager.h"
 #include <vector>
 #include <string>
 
-extern DocumentManager docManager;
 
+void CompletionSuggestion::write(JsonStream& out) const {
+	// نفس ترتيب المفاتيح الذي ينتجه تسلسل json
+	out.beginObject()
+		.key("detail").value(detail)
+		.key("documentation").value(documentation)
+		.key("kind").value(kind)
+		.key("label").value(label)
+		.endObject();
+}
+
+void CompletionSuggestion::writeSummary(JsonStream& out) const {
+	out.beginObject()
+		.key("kind").value(kind)
+		.key("label").value(label)
+		.endObject();
+}
 
-json Completion::getSuggestions() {
-	// Define enhanced completion item structure
-	struct CompletionItem {
-		std::string label{};
-		int kind{};  // LSP CompletionItemKind
-		std::string detail{};
-		std::string documentation{};
+bool Completion::writeSuggestions(JsonStream& out, const CancellationToken& token, bool summaries) {
+	out.beginObject().key("isIncomplete").value(false).key("items").beginArray();
+	bool completed = forEachSuggestion(token, [&out, summaries](const CompletionSuggestion& item) {
+		summaries ? item.writeSummary(out) : item.write(out);
+	});
+	if (!completed) {
+		return false;
+	}
+	out.endArray().endObject();
+	return true;
+}
+
+const std::string& Completion::serializedBuiltins(bool summaries) {
+	auto serialize = [](bool summaries) {
+		JsonStream out;
+		Completion().writeSuggestions(out, CancellationToken::none(), summaries);
+		return out.release();
 	};
+	static const std::string full = serialize(false);
+	static const std::string summarized = serialize(true);
+	return summaries ? summarized : full;
+}
 
+const CompletionSuggestion* Completion::findBuiltin(std::string_view label, int kind) {
+	// الاسم الواحد قد يكون دالة ونوعاً معاً: النوع يميز بينهما
+	const CompletionSuggestion* found = nullptr;
+	Completion().forEachSuggestion(CancellationToken::none(), [&](const CompletionSuggestion& item) {
+		if (!found && item.kind == kind && item.label == label) {
+			found = &item;
+		}
+	});
+	return found;
+}
+
+bool Completion::forEachSuggestion(const CancellationToken& token, const std::function<void(const CompletionSuggestion&)>& emit,
+	const std::function<void()>& step) {
 	// Build static suggestions (sorted alphabetically)
-	static const std::vector<CompletionItem> suggestions = [] {
-		std::vector<CompletionItem> items{};
+	static const std::vector<CompletionSuggestion> suggestions = [] {
+		std::vector<CompletionSuggestion> items{};
 
 		// Alif keywords (Kind: 14 - Keyword)
 		const std::vector<std::string> keywords = {
@@ -57,24 +98,22 @@ json Completion::getSuggestions() {
 
 		// Sort alphabetically
 		std::sort(items.begin(), items.end(),
-			[](const CompletionItem& a, const CompletionItem& b) {
+			[](const CompletionSuggestion& a, const CompletionSuggestion& b) {
 				return a.label < b.label;
 			});
 
 		return items;
 		}();
 
-	// Convert to JSON with proper snippet handling
-	json items = json::array();
 	for (const auto& item : suggestions) {
-		json j = {
-			{"label", item.label},
-			{"kind", item.kind},
-			{"detail", item.detail},
-			{"documentation", item.documentation}
-		};
-		items.push_back(j);
+		// نقطة إلغاء: لا فائدة من إكمال قائمة لن يقرأها أحد
+		if (token.isCancelled()) {
+			return false;
+		}
+		if (step) {
+			step();
+		}
+		emit(item);
 	}
-
-	return { {"isIncomplete", false}, {"items", items} };
+	return true;
 }
@@ -1,14 +1,64 @@
 #include "DocManager.h"
 #include "Logger.h"
 
+#include <algorithm>
+
+
+namespace {
+	// طول تسلسل UTF-8 الذي يبدأ بالبايت المعطى
+	size_t utf8SequenceLength(unsigned char lead) {
+		if (lead < 0x80) return 1;
+		if ((lead >> 5) == 0x6) return 2;
+		if ((lead >> 4) == 0xE) return 3;
+		if ((lead >> 3) == 0x1E) return 4;
+		return 1;  // بايت غير صالح يُعد حرفاً واحداً
+	}
+
+	// تحويل موضع LSP (سطر، عمود بوحدات الترميز المتفق عليه) إلى إزاحة بالبايت
+	// في نص UTF-8. المواضع خارج الحدود تُقصر على نهاية السطر أو النص
+	size_t offsetAt(const std::string& text, const TextPosition& position, PositionEncoding encoding) {
+		size_t offset = 0;
+		for (int line = 0; line < position.line; ++line) {
+			size_t newline = text.find('\n', offset);
+			if (newline == std::string::npos) {
+				return text.size();
+			}
+			offset = newline + 1;
+		}
+
+		// UTF-8: العمود إزاحة مباشرة دون المرور على حروف السطر
+		if (encoding == PositionEncoding::UTF8) {
+			size_t lineStart = offset;
+			size_t lineEnd = std::min(text.find('\n', lineStart), text.size());
+			offset += std::min(static_cast<size_t>(position.character), lineEnd - lineStart);
+			// عمود داخل حرف متعدد البايتات يُرد إلى بدايته لئلا يُقسم الحرف
+			while (offset > lineStart && offset < lineEnd && (static_cast<unsigned char>(text[offset]) & 0xC0) == 0x80) {
+				--offset;
+			}
+			return offset;
+		}
+
+		int units = 0;
+		while (offset < text.size() && units < position.character && text[offset] != '\n') {
+			size_t length = utf8SequenceLength(static_cast<unsigned char>(text[offset]));
+			// الأحرف خارج المستوى الأساسي تشغل وحدتين في UTF-16
+			units += length == 4 ? 2 : 1;
+			offset = std::min(offset + length, text.size());
+		}
+		return offset;
+	}
+}
+
 // فتح مستند جديد مع التحقق من الصحة
-DocumentError DocumentManager::openDocument(const std::string& uri, const std::string& text) {
+DocumentError DocumentManager::openDocument(const std::string& uri, std::string text) {
 	// التحقق من صحة URI
 	if (!isValidURI(uri)) {
 		Logger::warn("Attempt to open document with invalid URI: " + uri);
 		return DocumentError::INVALID_URI;
 	}
 
+	std::unique_lock<std::shared_mutex> lock(mutex);
+
 	// التحقق من عدم وجود المستند مسبقاً
 	if (documents.find(uri) != documents.end()) {
 		Logger::warn("Attempt to open already existing document: " + uri);
@@ -17,8 +67,9 @@ DocumentError DocumentManager::openDocument(const std::string& uri, const std::s
 
 	// حفظ المستند
 	try {
-		documents[uri] = text;
-		Logger::info("Document opened successfully: " + uri + " (" + std::to_string(text.length()) + " chars)");
+		size_t length = text.length();
+		documents.emplace(uri, std::move(text));
+		Logger::info("Document opened successfully: " + uri + " (" + std::to_string(length) + " chars)");
 		return DocumentError::SUCCESS;
 	}
 	catch (const std::exception& e) {
@@ -27,27 +78,36 @@ DocumentError DocumentManager::openDocument(const std::string& uri, const std::s
 	}
 }
 
-// تحديث مستند موجود
-DocumentError DocumentManager::updateDocument(const std::string& uri, const std::string& text) {
-	// التحقق من صحة URI
+// تطبيق تعديلات متتالية (كاملة أو ضمن نطاقات) على مستند موجود
+DocumentError DocumentManager::applyChanges(const std::string& uri, std::vector<TextChange> changes) {
 	if (!isValidURI(uri)) {
 		Logger::warn("Attempt to update document with invalid URI: " + uri);
 		return DocumentError::INVALID_URI;
 	}
 
-	// التحقق من وجود المستند
+	std::unique_lock<std::shared_mutex> lock(mutex);
+
 	auto it = documents.find(uri);
 	if (it == documents.end()) {
 		Logger::warn("Attempt to update non-existent document: " + uri);
 		return DocumentError::DOCUMENT_NOT_FOUND;
 	}
 
-	// تحديث المستند
 	try {
-		size_t oldSize = it->second.length();
-		documents[uri] = text;
+		std::string& text = it->second;
+		size_t oldSize = text.length();
+		for (TextChange& change : changes) {
+			if (!change.hasRange) {
+				text = std::move(change.text);
+				continue;
+			}
+			size_t start = offsetAt(text, change.start, positionEncoding);
+			size_t end = std::max(start, offsetAt(text, change.end, positionEncoding));
+			text.replace(start, end - start, change.text);
+		}
 		Logger::debug("Document updated: " + uri + " (" + std::to_string(oldSize) +
-			" -> " + std::to_string(text.length()) + " chars)");
+			" -> " + std::to_string(text.length()) + " chars, " +
+			std::to_string(changes.size()) + " changes)");
 		return DocumentError::SUCCESS;
 	}
 	catch (const std::exception& e) {
@@ -64,6 +124,8 @@ DocumentError DocumentManager::closeDocument(const std::string& uri) {
 		return DocumentError::INVALID_URI;
 	}
 
+	std::unique_lock<std::shared_mutex> lock(mutex);
+
 	// التحقق من وجود المستند
 	auto it = documents.find(uri);
 	if (it == documents.end()) {
@@ -83,24 +145,9 @@ DocumentError DocumentManager::closeDocument(const std::string& uri) {
 	}
 }
 
-// الحصول على نص المستند
-std::string DocumentManager::getDocumentText(const std::string& uri) const {
-	auto it = documents.find(uri);
-	if (it != documents.end()) {
-		return it->second;
-	}
-
-	Logger::debug("Requested text for non-existent document: " + uri);
-	return "";
-}
-
-// التحقق من وجود المستند
-bool DocumentManager::hasDocument(const std::string& uri) const {
-	return documents.find(uri) != documents.end();
-}
-
 // عدد المستندات المفتوحة
 size_t DocumentManager::getDocumentCount() const {
+	std::shared_lock<std::shared_mutex> lock(mutex);
 	return documents.size();
 }
 
@@ -0,0 +1,138 @@
+#include "JsonStream.h"
+#include "JsonString.h"
+
+#include <charconv>
+
+
+JsonStream::JsonStream(std::string buffer) : out(std::move(buffer)), start(out.size()) {}
+
+void JsonStream::separate() {
+	if (needComma) {
+		out += ',';
+	}
+}
+
+JsonStream& JsonStream::beginObject() {
+	separate();
+	out += '{';
+	needComma = false;
+	return *this;
+}
+
+JsonStream& JsonStream::endObject() {
+	out += '}';
+	needComma = true;
+	return *this;
+}
+
+JsonStream& JsonStream::beginArray() {
+	separate();
+	out += '[';
+	needComma = false;
+	return *this;
+}
+
+JsonStream& JsonStream::endArray() {
+	out += ']';
+	needComma = true;
+	return *this;
+}
+
+JsonStream& JsonStream::key(std::string_view name) {
+	separate();
+	writeString(name);
+	out += ':';
+	needComma = false;
+	return *this;
+}
+
+JsonStream& JsonStream::value(std::string_view text) {
+	separate();
+	writeString(text);
+	needComma = true;
+	return *this;
+}
+
+JsonStream& JsonStream::value(bool flag) {
+	separate();
+	out += flag ? "true" : "false";
+	needComma = true;
+	return *this;
+}
+
+JsonStream& JsonStream::value(int64_t number) {
+	separate();
+	char digits[24];
+	auto result = std::to_chars(digits, digits + sizeof(digits), number);
+	out.append(digits, result.ptr);
+	needComma = true;
+	return *this;
+}
+
+JsonStream& JsonStream::value(uint64_t number) {
+	separate();
+	char digits[24];
+	auto result = std::to_chars(digits, digits + sizeof(digits), number);
+	out.append(digits, result.ptr);
+	needComma = true;
+	return *this;
+}
+
+JsonStream& JsonStream::value(std::nullptr_t) {
+	separate();
+	out += "null";
+	needComma = true;
+	return *this;
+}
+
+JsonStream& JsonStream::value(const json& node) {
+	separate();
+	nlohmann::detail::serializer<json> serializer(nlohmann::detail::output_adapter<char>(out), ' ');
+	serializer.dump(node, false, false, 0);
+	needComma = true;
+	return *this;
+}
+
+JsonStream& JsonStream::raw(std::string_view serialized) {
+	separate();
+	out.append(serialized);
+	needComma = true;
+	return *this;
+}
+
+void JsonStream::writeString(std::string_view text) {
+	// UTF-8 غير صالح: نفس الاستثناء الذي يرميه تسلسل json
+	if (!JsonStringDecoder::isValidUtf8(text)) {
+		nlohmann::detail::serializer<json> serializer(nlohmann::detail::output_adapter<char>(out), ' ');
+		serializer.dump(json(std::string(text)), false, false, 0);
+		return;
+	}
+
+	// البايتات التي تحتاج هروباً هي نفسها التي يتوقف عندها فك النصوص
+	out += '"';
+	while (!text.empty()) {
+		size_t run = JsonStringDecoder::findSpecial(text.data(), text.size());
+		out.append(text.data(), run);
+		if (run == text.size()) {
+			break;
+		}
+		char c = text[run];
+		switch (c) {
+		case '"': out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\b': out += "\\b"; break;
+		case '\f': out += "\\f"; break;
+		case '\n': out += "\\n"; break;
+		case '\r': out += "\\r"; break;
+		case '\t': out += "\\t"; break;
+		default: {
+			static constexpr char HEX[] = "0123456789abcdef";
+			out += "\\u00";
+			out += HEX[(c >> 4) & 0xF];
+			out += HEX[c & 0xF];
+		}
+		}
+		text.remove_prefix(run + 1);
+	}
+	out += '"';
+}
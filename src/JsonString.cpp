@@ -0,0 +1,323 @@
+#include "JsonString.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ALIF_SIMD_X64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+// AVX2 يُختار عند التشغيل إن دعمه المعالج (GCC/Clang)، أو عند الترجمة بـ /arch:AVX2
+#if defined(__GNUC__) || defined(__AVX2__)
+#define ALIF_SIMD_AVX2 1
+#endif
+#endif
+
+
+namespace {
+	// البايتات التي توقف نسخ النص: نهايته، بداية هروب، وبايتات التحكم الممنوعة
+	constexpr std::array<bool, 256> SPECIAL = [] {
+		std::array<bool, 256> table{};
+		for (int c = 0; c < 0x20; ++c) {
+			table[c] = true;
+		}
+		table['"'] = true;
+		table['\\'] = true;
+		return table;
+	}();
+
+	size_t findSpecialScalar(const char* data, size_t size) {
+		size_t i = 0;
+		while (i < size && !SPECIAL[static_cast<unsigned char>(data[i])]) {
+			++i;
+		}
+		return i;
+	}
+
+#if defined(ALIF_SIMD_X64)
+	inline unsigned firstBit(unsigned mask) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+
+	// SSE2 جزء من x86-64 الأساسي فلا يحتاج فحصاً؛ مقارنات التساوي الثلاث أسرع هنا من pcmpistri
+	size_t findSpecialSse2(const char* data, size_t size) {
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i control = _mm_set1_epi8(0x1F);
+		size_t i = 0;
+		for (; i + 16 <= size; i += 16) {
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			// البايت <= 0x1F (بلا إشارة) إذا لم يغيره الحد الأدنى مع 0x1F
+			__m128i special = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)),
+				_mm_cmpeq_epi8(_mm_min_epu8(bytes, control), bytes));
+			unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+			if (mask != 0) {
+				return i + firstBit(mask);
+			}
+		}
+		return i + findSpecialScalar(data + i, size - i);
+	}
+
+#if defined(ALIF_SIMD_AVX2)
+#if defined(__GNUC__)
+	__attribute__((target("avx2")))
+#endif
+	size_t findSpecialAvx2(const char* data, size_t size) {
+		const __m256i quote = _mm256_set1_epi8('"');
+		const __m256i backslash = _mm256_set1_epi8('\\');
+		const __m256i control = _mm256_set1_epi8(0x1F);
+		size_t i = 0;
+		for (; i + 32 <= size; i += 32) {
+			__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			__m256i special = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote), _mm256_cmpeq_epi8(bytes, backslash)),
+				_mm256_cmpeq_epi8(_mm256_min_epu8(bytes, control), bytes));
+			unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+			if (mask != 0) {
+				return i + firstBit(mask);
+			}
+		}
+		// أسطر المصدر قصيرة: الذيل يُمسح بـ 16 بايت هنا لا باستدعاء findSpecialSse2،
+		// فالانتقال من AVX إلى تعليمات SSE غير المرمزة بـ VEX مكلف على بعض المعالجات
+		for (; i + 16 <= size; i += 16) {
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			__m128i special = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(quote)),
+					_mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(backslash))),
+				_mm_cmpeq_epi8(_mm_min_epu8(bytes, _mm256_castsi256_si128(control)), bytes));
+			unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+			if (mask != 0) {
+				return i + firstBit(mask);
+			}
+		}
+		while (i < size && !SPECIAL[static_cast<unsigned char>(data[i])]) {
+			++i;
+		}
+		return i;
+	}
+#endif
+#endif
+
+	using FindSpecial = size_t (*)(const char*, size_t);
+
+	FindSpecial selectFindSpecial() {
+#if defined(ALIF_SIMD_AVX2) && defined(__AVX2__)
+		return findSpecialAvx2;
+#elif defined(ALIF_SIMD_AVX2)
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") ? findSpecialAvx2 : findSpecialSse2;
+#elif defined(ALIF_SIMD_X64)
+		return findSpecialSse2;
+#else
+		return findSpecialScalar;
+#endif
+	}
+
+	int hexValue(char c) {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	// قيمة أربعة أرقام ست عشرية (أو -1)
+	int parseHex4(const char* digits) {
+		int value = 0;
+		for (int i = 0; i < 4; ++i) {
+			int digit = hexValue(digits[i]);
+			if (digit < 0) {
+				return -1;
+			}
+			value = (value << 4) | digit;
+		}
+		return value;
+	}
+}
+
+size_t JsonStringDecoder::findSpecial(const char* data, size_t size) {
+	static const FindSpecial implementation = selectFindSpecial();
+	return implementation(data, size);
+}
+
+JsonStringDecoder::Status JsonStringDecoder::feed(std::string_view input, size_t& consumed) {
+	const char* data = input.data();
+	size_t size = input.size();
+	size_t pos = 0;
+
+	while (pos < size) {
+		// تسلسل هروب بدأ في مقطع سابق أو للتو
+		if (escapeSize > 0) {
+			if (!pushEscape(data[pos++])) {
+				consumed = pos;
+				return Status::INVALID;
+			}
+			continue;
+		}
+
+		size_t run = findSpecial(data + pos, size - pos);
+		if (output) {
+			output->append(data + pos, run);
+		}
+		pos += run;
+		if (pos == size) {
+			break;
+		}
+
+		char c = data[pos++];
+		if (c == '"') {
+			consumed = pos;
+			return Status::DONE;
+		}
+		if (c == '\\') {
+			escape[0] = c;
+			escapeSize = 1;
+		}
+		else if (output) {
+			// بايت تحكم غير مهرب
+			consumed = pos;
+			return Status::INVALID;
+		}
+	}
+
+	consumed = size;
+	return Status::NEED_MORE;
+}
+
+bool JsonStringDecoder::pushEscape(char c) {
+	escape[escapeSize++] = c;
+	// التخطي: يكفي ألا يُعد الحرف التالي لـ '\' نهاية للنص
+	if (!output) {
+		escapeSize = 0;
+		return true;
+	}
+
+	switch (escapeSize) {
+	case 2:
+		switch (c) {
+		case '"': case '\\': case '/': output->push_back(c); break;
+		case 'b': output->push_back('\b'); break;
+		case 'f': output->push_back('\f'); break;
+		case 'n': output->push_back('\n'); break;
+		case 'r': output->push_back('\r'); break;
+		case 't': output->push_back('\t'); break;
+		case 'u': return true;
+		default: return false;
+		}
+		escapeSize = 0;
+		return true;
+	case 6: {
+		int codePoint = parseHex4(escape + 2);
+		if (codePoint < 0 || (codePoint >= 0xDC00 && codePoint <= 0xDFFF)) {
+			return false;
+		}
+		// النصف الأول من زوج: انتظار \uXXXX التالي
+		if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+			return true;
+		}
+		appendCodePoint(static_cast<unsigned>(codePoint));
+		escapeSize = 0;
+		return true;
+	}
+	case 7:
+		return c == '\\';
+	case 8:
+		return c == 'u';
+	case 12: {
+		int high = parseHex4(escape + 2);
+		int low = parseHex4(escape + 8);
+		if (low < 0xDC00 || low > 0xDFFF) {
+			return false;
+		}
+		appendCodePoint(0x10000 + ((static_cast<unsigned>(high) - 0xD800) << 10) + (static_cast<unsigned>(low) - 0xDC00));
+		escapeSize = 0;
+		return true;
+	}
+	default:
+		return true;
+	}
+}
+
+void JsonStringDecoder::appendCodePoint(unsigned codePoint) {
+	if (codePoint < 0x80) {
+		output->push_back(static_cast<char>(codePoint));
+	}
+	else if (codePoint < 0x800) {
+		output->push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+		output->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+	else if (codePoint < 0x10000) {
+		output->push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+		output->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		output->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+	else {
+		output->push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+		output->push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+		output->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		output->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+}
+
+// التسلسلات المقبولة وفق RFC 3629 (دون الطويلة أو أنصاف الأزواج أو ما بعد U+10FFFF)
+bool JsonStringDecoder::isValidUtf8(std::string_view text) {
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text.data());
+	size_t size = text.size();
+	size_t i = 0;
+	while (i < size) {
+		unsigned char lead = bytes[i];
+		if (lead < 0x80) {
+			// تخطي ASCII ثمانية بايتات في كل مرة
+			uint64_t word = 0x80;
+			if (i + 8 <= size) {
+				std::memcpy(&word, bytes + i, sizeof(word));
+			}
+			i += (word & 0x8080808080808080ULL) == 0 ? 8 : 1;
+			continue;
+		}
+		// الحروف العربية كلها من بايتين: أكثر الحالات تكراراً أولاً
+		if (lead >= 0xC2 && lead <= 0xDF) {
+			if (i + 1 >= size || (bytes[i + 1] & 0xC0) != 0x80) {
+				return false;
+			}
+			i += 2;
+			continue;
+		}
+
+		size_t length;
+		unsigned char low = 0x80, high = 0xBF;
+		if (lead >= 0xE0 && lead <= 0xEF) {
+			length = 3;
+			if (lead == 0xE0) low = 0xA0;
+			if (lead == 0xED) high = 0x9F;
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4) {
+			length = 4;
+			if (lead == 0xF0) low = 0x90;
+			if (lead == 0xF4) high = 0x8F;
+		}
+		else {
+			return false;
+		}
+
+		if (size - i < length || bytes[i + 1] < low || bytes[i + 1] > high) {
+			return false;
+		}
+		for (size_t k = 2; k < length; ++k) {
+			if (bytes[i + k] < 0x80 || bytes[i + k] > 0xBF) {
+				return false;
+			}
+		}
+		i += length;
+	}
+	return true;
+}
@@ -0,0 +1,408 @@
+#include "ListenServer.h"
+#include "Logger.h"
+#include "Metrics.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <csignal>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+bool ListenAddress::parse(const std::string& text, ListenAddress& address) {
+	if (text.rfind("unix:", 0) == 0) {
+		address.kind = Kind::UNIX;
+		address.path = text.substr(5);
+		return !address.path.empty();
+	}
+	if (text.rfind("tcp:", 0) == 0) {
+		std::string value = text.substr(4);
+		char* end = nullptr;
+		unsigned long port = std::strtoul(value.c_str(), &end, 10);
+		if (value.empty() || *end != '\0' || port > 65535) {
+			return false;
+		}
+		address.kind = Kind::TCP;
+		address.port = static_cast<uint16_t>(port);
+		return true;
+	}
+	return false;
+}
+
+std::string ListenAddress::toString() const {
+	if (kind == Kind::UNIX) {
+		return "unix:" + path;
+	}
+	return "tcp:127.0.0.1:" + std::to_string(port);
+}
+
+ListenServer::ListenServer(const ServerOptions& options, const ListenAddress& address)
+	: options(options), address(address), pool(options.workerThreads) {}
+
+#if defined(__linux__)
+
+ListenServer::~ListenServer() {
+	for (int fd : { listenFd, epollFd, signalFd }) {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+	if (listenFd >= 0 && address.kind == ListenAddress::Kind::UNIX) {
+		unlink(address.path.c_str());
+	}
+}
+
+bool ListenServer::openListener() {
+	if (address.kind == ListenAddress::Kind::UNIX) {
+		sockaddr_un socketAddress{};
+		socketAddress.sun_family = AF_UNIX;
+		if (address.path.size() >= sizeof(socketAddress.sun_path)) {
+			Logger::error("Socket path too long: " + address.path);
+			return false;
+		}
+		std::memcpy(socketAddress.sun_path, address.path.c_str(), address.path.size() + 1);
+
+		listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (listenFd < 0) {
+			Logger::error("Cannot create socket: " + std::string(std::strerror(errno)));
+			return false;
+		}
+
+		// مقبس متبقٍ من تشغيل سابق يُحذف، أما مقبس خادم يعمل فلا يُمس
+		struct stat info{};
+		if (lstat(address.path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+			int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+			bool alive = probe >= 0 &&
+				connect(probe, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) == 0;
+			if (probe >= 0) {
+				close(probe);
+			}
+			if (alive) {
+				Logger::error("Another server is already listening on " + address.path);
+				close(listenFd);
+				listenFd = -1;
+				return false;
+			}
+			unlink(address.path.c_str());
+		}
+
+		// المقبس متاح لمالكه فقط
+		mode_t previousMask = umask(0177);
+		int bound = bind(listenFd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress));
+		umask(previousMask);
+		if (bound != 0) {
+			Logger::error("Cannot bind " + address.path + ": " + std::string(std::strerror(errno)));
+			close(listenFd);
+			listenFd = -1;
+			return false;
+		}
+	}
+	else {
+		listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (listenFd < 0) {
+			Logger::error("Cannot create socket: " + std::string(std::strerror(errno)));
+			return false;
+		}
+		int reuse = 1;
+		setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		// الاستماع على الواجهة المحلية فقط: لا مصادقة في بروتوكول LSP
+		sockaddr_in socketAddress{};
+		socketAddress.sin_family = AF_INET;
+		socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		socketAddress.sin_port = htons(address.port);
+		if (bind(listenFd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0) {
+			Logger::error("Cannot bind port " + std::to_string(address.port) + ": " + std::string(std::strerror(errno)));
+			close(listenFd);
+			listenFd = -1;
+			return false;
+		}
+		socklen_t length = sizeof(socketAddress);
+		if (getsockname(listenFd, reinterpret_cast<sockaddr*>(&socketAddress), &length) == 0) {
+			address.port = ntohs(socketAddress.sin_port);
+		}
+	}
+
+	if (listen(listenFd, SOMAXCONN) != 0) {
+		Logger::error("Cannot listen on " + address.toString() + ": " + std::string(std::strerror(errno)));
+		return false;
+	}
+	return true;
+}
+
+void ListenServer::acceptConnections() {
+	static Metric& accepted = Metrics::get("connections.accepted");
+	static Metric& active = Metrics::get("connections.active");
+
+	while (true) {
+		int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				Logger::error("Failed to accept connection: " + std::string(std::strerror(errno)));
+			}
+			return;
+		}
+		if (address.kind == ListenAddress::Kind::TCP) {
+			int noDelay = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+		}
+
+		auto connection = std::make_unique<Connection>();
+		connection->fd = fd;
+		connection->framer.setMaxMessageSize(options.maxMessageSize);
+		connection->session = std::make_unique<LSPServer>(options, pool, fd);
+
+		epoll_event event{};
+		event.events = EPOLLIN | EPOLLRDHUP;
+		event.data.fd = fd;
+		if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+			Logger::error("Cannot watch connection: " + std::string(std::strerror(errno)));
+			close(fd);
+			continue;
+		}
+		connection->session->start();
+		connections.emplace(fd, std::move(connection));
+
+		accepted.add();
+		active.set(static_cast<int64_t>(connections.size()));
+		Logger::info("Client connected (fd " + std::to_string(fd) + ")");
+	}
+}
+
+bool ListenServer::readConnection(Connection& connection) {
+	// الرسالة الكبيرة تُقرأ مباشرة إلى كتلها، وغيرها إلى مخزن المُقطِّع
+	char* data = nullptr;
+	size_t capacity = 0;
+	if (connection.readingLarge) {
+		data = connection.body.chunks.writableData();
+		capacity = connection.body.chunks.writableSize();
+	}
+	else {
+		data = connection.framer.writableData(READ_CHUNK);
+		capacity = connection.framer.writableSize();
+	}
+
+	ssize_t count = ::read(connection.fd, data, capacity);
+	if (count < 0) {
+		if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+			return true;
+		}
+		if (errno != ECONNRESET) {
+			Logger::error("Failed to read from connection: " + std::string(std::strerror(errno)));
+		}
+		return false;
+	}
+	if (count == 0) {
+		if (connection.readingLarge || connection.framer.bufferedSize() > 0) {
+			Logger::warn("Connection closed with incomplete message");
+		}
+		return false;
+	}
+
+	if (connection.readingLarge) {
+		connection.body.chunks.commit(static_cast<size_t>(count));
+	}
+	else {
+		connection.framer.commit(static_cast<size_t>(count));
+	}
+	return processFrames(connection);
+}
+
+bool ListenServer::processFrames(Connection& connection) {
+	MessageBody& body = connection.body;
+	LSPServer& session = *connection.session;
+
+	while (!session.finished()) {
+		if (connection.readingLarge) {
+			// سحب ما سبق تخزينه ثم انتظار بقية الرسالة
+			while (!body.chunks.complete()) {
+				size_t taken = connection.framer.take(body.chunks.writableData(), body.chunks.writableSize());
+				if (taken == 0) {
+					return true;
+				}
+				body.chunks.commit(taken);
+			}
+			connection.readingLarge = false;
+		}
+		else {
+			FrameStatus status = connection.framer.next(body.data);
+			if (status == FrameStatus::NEED_MORE) {
+				return true;
+			}
+			if (status == FrameStatus::LARGE_MESSAGE) {
+				Logger::debug("Reading large message in chunks: " +
+					std::to_string(connection.framer.lastLength()) + " bytes");
+				body.chunked = true;
+				body.chunks.reset(&chunkPool, connection.framer.lastLength());
+				connection.readingLarge = true;
+				continue;
+			}
+			if (reportFrameError(status, connection.framer)) {
+				continue;
+			}
+			body.chunked = false;
+		}
+
+		json content;
+		if (session.parseMessage(body, content)) {
+			session.deliver(std::move(content));
+		}
+		body.chunked = false;
+	}
+	return false;
+}
+
+void ListenServer::closeConnection(int fd) {
+	static Metric& active = Metrics::get("connections.active");
+
+	auto it = connections.find(fd);
+	if (it == connections.end()) {
+		return;
+	}
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+	it->second->closedAt = std::chrono::steady_clock::now();
+	closing.push_back(std::move(it->second));
+	connections.erase(it);
+	active.set(static_cast<int64_t>(connections.size()));
+	Logger::info("Client disconnected (fd " + std::to_string(fd) + ")");
+}
+
+// كتابة ما تبقى من ردود الجلسة ثم إغلاق المقبس
+void ListenServer::finishConnection(Connection& connection) {
+	if (!connection.session->stopOutput(CLOSE_TIMEOUT)) {
+		// العميل لا يقرأ: إيقاظ الكتابة المعلقة بإغلاق المقبس
+		Logger::warn("Timed out flushing output for fd " + std::to_string(connection.fd));
+		shutdown(connection.fd, SHUT_RDWR);
+	}
+	connection.session.reset();
+	close(connection.fd);
+}
+
+void ListenServer::reapClosing(bool wait) {
+	auto now = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < closing.size();) {
+		Connection& connection = *closing[i];
+		LSPServer& session = *connection.session;
+
+		bool idle = session.waitForTasks(wait ? CLOSE_TIMEOUT : std::chrono::milliseconds(0));
+		if (!idle && (wait || now - connection.closedAt > CLOSE_TIMEOUT) && !connection.cancelled) {
+			Logger::warn("Session tasks did not finish in time, cancelling pending requests");
+			session.cancelPending();
+			connection.cancelled = true;
+			idle = wait && session.waitForTasks(CLOSE_TIMEOUT);
+		}
+		if (!idle) {
+			if (wait) {
+				// مهام لا تستجيب للإلغاء تمنع إتلاف الجلسة بأمان
+				Logger::error("Session tasks still running after cancellation, terminating");
+				std::_Exit(1);
+			}
+			++i;
+			continue;
+		}
+
+		finishConnection(connection);
+		closing.erase(closing.begin() + static_cast<std::ptrdiff_t>(i));
+	}
+}
+
+int ListenServer::run() {
+	// الإشارات تُستقبل عبر signalfd في حلقة الأحداث، لذا تُحجب قبل إنشاء أي خيط
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+	signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (signalFd < 0 || epollFd < 0) {
+		Logger::error("Cannot create event loop: " + std::string(std::strerror(errno)));
+		return 1;
+	}
+
+	if (!openListener()) {
+		return 1;
+	}
+
+	for (int fd : { listenFd, signalFd }) {
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+			Logger::error("Cannot watch listening socket: " + std::string(std::strerror(errno)));
+			return 1;
+		}
+	}
+
+	pool.start();
+	Logger::info("Alif Server listening on " + address.toString());
+
+	epoll_event events[MAX_EVENTS];
+	bool stopping = false;
+	while (!stopping) {
+		int timeout = closing.empty() ? -1 : CLOSING_POLL_MS;
+		int count = epoll_wait(epollFd, events, MAX_EVENTS, timeout);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			Logger::error("Event loop failed: " + std::string(std::strerror(errno)));
+			break;
+		}
+
+		for (int i = 0; i < count; ++i) {
+			int fd = events[i].data.fd;
+			if (fd == signalFd) {
+				signalfd_siginfo info{};
+				[[maybe_unused]] ssize_t ignored = ::read(signalFd, &info, sizeof(info));
+				Logger::info("Stop signal received");
+				stopping = true;
+			}
+			else if (fd == listenFd) {
+				acceptConnections();
+			}
+			else {
+				auto it = connections.find(fd);
+				if (it != connections.end() && !readConnection(*it->second)) {
+					closeConnection(fd);
+				}
+			}
+		}
+
+		reapClosing(false);
+	}
+
+	while (!connections.empty()) {
+		closeConnection(connections.begin()->first);
+	}
+	reapClosing(true);
+	pool.stop();
+
+	Logger::info("Server metrics: " + Metrics::snapshot().dump());
+	return 0;
+}
+
+#else
+
+ListenServer::~ListenServer() {}
+
+int ListenServer::run() {
+	Logger::error("--listen is only supported on Linux");
+	return 1;
+}
+
+#endif
@@ -1,15 +1,21 @@
 #include "Logger.h"
 
+#include <mutex>
+
 
 
 
 // تهيئة المتغير الثابت - المستوى الافتراضي للتسجيل
 LogLevel Logger::currentLevel = LogLevel::INFO;
 
+// منع تداخل أسطر السجل القادمة من عدة خيوط
+static std::mutex logMutex;
+
 
 
 void Logger::log(LogLevel level, const std::string& message) {
 	if (level >= currentLevel) {
+		std::lock_guard<std::mutex> lock(logMutex);
 		std::cerr << "[Alif-LSP] " << levelToString(level) << ": " << message << std::endl;
 	}
 }
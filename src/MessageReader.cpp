@@ -0,0 +1,472 @@
+#include "MessageReader.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <string>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <io.h>
+#include <windows.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+	// حجم القراءة الواحدة من واصف الملف
+	constexpr size_t READ_CHUNK = 64 * 1024;
+	// أقصى حجم للرؤوس قبل اعتبار البيانات تالفة
+	constexpr size_t MAX_HEADER_SIZE = 8 * 1024;
+
+	constexpr std::string_view CONTENT_LENGTH = "content-length:";
+
+	bool startsWithIgnoreCase(std::string_view line, std::string_view prefix) {
+		if (line.size() < prefix.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < prefix.size(); ++i) {
+			char c = line[i];
+			if (c >= 'A' && c <= 'Z') {
+				c = static_cast<char>(c - 'A' + 'a');
+			}
+			if (c != prefix[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+MessageFramer::MessageFramer(size_t initialCapacity)
+	: buffer(initialCapacity > 0 ? initialCapacity : DEFAULT_CAPACITY) {}
+
+char* MessageFramer::writableData(size_t minSize) {
+	if (buffer.size() - end < minSize) {
+		compact();
+	}
+	if (buffer.size() - end < minSize) {
+		buffer.resize(std::max(buffer.size() * 2, end + minSize));
+	}
+	return buffer.data() + end;
+}
+
+size_t MessageFramer::writableSize() const {
+	return buffer.size() - end;
+}
+
+void MessageFramer::commit(size_t count) {
+	end += std::min(count, buffer.size() - end);
+}
+
+// نقل البيانات غير المستهلكة إلى بداية المخزن
+void MessageFramer::compact() {
+	if (begin == 0) {
+		return;
+	}
+	size_t remaining = end - begin;
+	if (remaining > 0) {
+		std::memmove(buffer.data(), buffer.data() + begin, remaining);
+	}
+	begin = 0;
+	end = remaining;
+}
+
+size_t MessageFramer::findHeaderEnd() const {
+	const char* data = buffer.data();
+	size_t pos = begin;
+	while (pos < end) {
+		const void* found = std::memchr(data + pos, '\n', end - pos);
+		if (!found) {
+			return 0;
+		}
+		size_t newline = static_cast<const char*>(found) - data;
+		// السطر الفارغ ينهي الرؤوس ("\r\n" أو "\n" فقط)
+		size_t lineStart = pos;
+		size_t lineLength = newline - lineStart;
+		if (lineLength == 0 || (lineLength == 1 && data[lineStart] == '\r')) {
+			return newline + 1;
+		}
+		pos = newline + 1;
+	}
+	return 0;
+}
+
+FrameStatus MessageFramer::parseHeaders(size_t headerEnd, size_t& length) const {
+	const char* data = buffer.data();
+	bool found = false;
+	size_t pos = begin;
+
+	while (pos < headerEnd) {
+		size_t newline = static_cast<const char*>(std::memchr(data + pos, '\n', headerEnd - pos)) - data;
+		std::string_view line(data + pos, newline - pos);
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+		pos = newline + 1;
+
+		if (!startsWithIgnoreCase(line, CONTENT_LENGTH)) {
+			continue;
+		}
+
+		std::string_view value = line.substr(CONTENT_LENGTH.size());
+		while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+			value.remove_prefix(1);
+		}
+		while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+			value.remove_suffix(1);
+		}
+		if (value.empty() || value.size() > 18) {
+			return FrameStatus::INVALID_LENGTH;
+		}
+
+		size_t parsed = 0;
+		for (char c : value) {
+			if (c < '0' || c > '9') {
+				return FrameStatus::INVALID_LENGTH;
+			}
+			parsed = parsed * 10 + static_cast<size_t>(c - '0');
+		}
+		length = parsed;
+		found = true;
+	}
+
+	return found ? FrameStatus::MESSAGE : FrameStatus::MISSING_LENGTH;
+}
+
+FrameStatus MessageFramer::next(std::string_view& body) {
+	// تجاهل بقية محتوى رسالة مرفوضة سابقاً
+	if (pendingSkip > 0) {
+		size_t skipped = std::min(pendingSkip, end - begin);
+		begin += skipped;
+		pendingSkip -= skipped;
+		if (pendingSkip > 0) {
+			return FrameStatus::NEED_MORE;
+		}
+	}
+
+	if (begin == end) {
+		begin = end = 0;
+		return FrameStatus::NEED_MORE;
+	}
+
+	size_t headerEnd = findHeaderEnd();
+	if (headerEnd == 0) {
+		// رؤوس طويلة بشكل غير معقول: تجاهل البيانات التالفة
+		if (end - begin > MAX_HEADER_SIZE) {
+			begin = end;
+			return FrameStatus::MISSING_LENGTH;
+		}
+		return FrameStatus::NEED_MORE;
+	}
+
+	size_t length = 0;
+	FrameStatus status = parseHeaders(headerEnd, length);
+	if (status != FrameStatus::MESSAGE) {
+		begin = headerEnd;
+		return status;
+	}
+	declaredLength = length;
+
+	if (length == 0) {
+		begin = headerEnd;
+		return FrameStatus::EMPTY_MESSAGE;
+	}
+
+	if (length > maxMessageSize) {
+		begin = headerEnd;
+		pendingSkip = length;
+		size_t skipped = std::min(pendingSkip, end - begin);
+		begin += skipped;
+		pendingSkip -= skipped;
+		return FrameStatus::TOO_LARGE;
+	}
+
+	// الرسائل الكبيرة لا تُجمع في المخزن المتصل بل يسحبها القارئ على كتل
+	if (length > CONTIGUOUS_LIMIT) {
+		begin = headerEnd;
+		return FrameStatus::LARGE_MESSAGE;
+	}
+
+	if (end - headerEnd < length) {
+		return FrameStatus::NEED_MORE;
+	}
+
+	body = std::string_view(buffer.data() + headerEnd, length);
+	begin = headerEnd + length;
+	return FrameStatus::MESSAGE;
+}
+
+size_t MessageFramer::take(char* destination, size_t maxCount) {
+	size_t count = std::min(maxCount, end - begin);
+	if (count > 0) {
+		std::memcpy(destination, buffer.data() + begin, count);
+		begin += count;
+	}
+	return count;
+}
+
+std::unique_ptr<char[]> ChunkPool::acquire() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!chunks.empty()) {
+			std::unique_ptr<char[]> chunk = std::move(chunks.back());
+			chunks.pop_back();
+			return chunk;
+		}
+	}
+	return std::make_unique_for_overwrite<char[]>(CHUNK_SIZE);
+}
+
+void ChunkPool::release(std::unique_ptr<char[]> chunk) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (chunks.size() < MAX_POOLED_CHUNKS) {
+		chunks.push_back(std::move(chunk));
+	}
+}
+
+ChunkedBody::ChunkedBody(ChunkedBody&& other) noexcept
+	: pool(other.pool), chunks(std::move(other.chunks)),
+	expected(other.expected), received(other.received) {
+	other.chunks.clear();
+	other.expected = other.received = 0;
+}
+
+ChunkedBody& ChunkedBody::operator=(ChunkedBody&& other) noexcept {
+	if (this != &other) {
+		releaseChunks();
+		pool = other.pool;
+		chunks = std::move(other.chunks);
+		expected = other.expected;
+		received = other.received;
+		other.chunks.clear();
+		other.expected = other.received = 0;
+	}
+	return *this;
+}
+
+ChunkedBody::~ChunkedBody() {
+	releaseChunks();
+}
+
+void ChunkedBody::releaseChunks() {
+	for (auto& chunk : chunks) {
+		if (pool) {
+			pool->release(std::move(chunk));
+		}
+	}
+	chunks.clear();
+}
+
+void ChunkedBody::reset(ChunkPool* newPool, size_t expectedSize) {
+	releaseChunks();
+	pool = newPool;
+	expected = expectedSize;
+	received = 0;
+	chunks.reserve((expectedSize + ChunkPool::CHUNK_SIZE - 1) / ChunkPool::CHUNK_SIZE);
+}
+
+char* ChunkedBody::writableData() {
+	size_t offset = received % ChunkPool::CHUNK_SIZE;
+	if (offset == 0 && received / ChunkPool::CHUNK_SIZE == chunks.size()) {
+		chunks.push_back(pool->acquire());
+	}
+	return chunks.back().get() + offset;
+}
+
+size_t ChunkedBody::writableSize() const {
+	size_t offset = received % ChunkPool::CHUNK_SIZE;
+	return std::min(ChunkPool::CHUNK_SIZE - offset, expected - received);
+}
+
+void ChunkedBody::commit(size_t count) {
+	received += std::min(count, expected - received);
+}
+
+std::string_view ChunkedBody::preview(size_t count) const {
+	if (chunks.empty()) {
+		return {};
+	}
+	return std::string_view(chunks.front().get(), std::min({ count, received, ChunkPool::CHUNK_SIZE }));
+}
+
+std::string_view ChunkedBody::segment(size_t index) const {
+	size_t offset = index * ChunkPool::CHUNK_SIZE;
+	if (index >= chunks.size() || offset >= received) {
+		return {};
+	}
+	return std::string_view(chunks[index].get(), std::min(ChunkPool::CHUNK_SIZE, received - offset));
+}
+
+bool reportFrameError(FrameStatus status, const MessageFramer& framer) {
+	switch (status) {
+	case FrameStatus::MISSING_LENGTH:
+		Logger::warn("Message received without Content-Length header");
+		return true;
+	case FrameStatus::INVALID_LENGTH:
+		Logger::warn("Invalid Content-Length header");
+		return true;
+	case FrameStatus::EMPTY_MESSAGE:
+		Logger::warn("Empty message received (Content-Length: 0)");
+		return true;
+	case FrameStatus::TOO_LARGE:
+		Logger::warn("Message too large: " + std::to_string(framer.lastLength()) +
+			" bytes (limit " + std::to_string(framer.getMaxMessageSize()) + "), skipped");
+		return true;
+	default:
+		return false;
+	}
+}
+
+MessageReader::MessageReader(int fd, size_t initialCapacity)
+	: fd(fd), framer(initialCapacity) {
+#if !defined(_WIN32)
+	if (pipe(wakeFds) != 0) {
+		wakeFds[0] = wakeFds[1] = -1;
+		Logger::warn("Cannot create reader wake pipe: " + std::string(std::strerror(errno)));
+	}
+#endif
+}
+
+MessageReader::~MessageReader() {
+#if !defined(_WIN32)
+	for (int wakeFd : wakeFds) {
+		if (wakeFd >= 0) {
+			close(wakeFd);
+		}
+	}
+#endif
+}
+
+void MessageReader::interrupt() {
+	interrupted.store(true, std::memory_order_release);
+#if defined(_WIN32)
+	// إلغاء القراءة المتزامنة المعلقة على المقبض
+	CancelIoEx(reinterpret_cast<HANDLE>(_get_osfhandle(fd)), nullptr);
+#else
+	if (wakeFds[1] >= 0) {
+		char signal = 1;
+		[[maybe_unused]] ssize_t ignored = write(wakeFds[1], &signal, 1);
+	}
+#endif
+}
+
+long MessageReader::fill() {
+	char* data = framer.writableData(READ_CHUNK);
+	long count = readInto(data, framer.writableSize());
+	if (count > 0) {
+		framer.commit(static_cast<size_t>(count));
+	}
+	return count;
+}
+
+long MessageReader::readInto(char* data, size_t capacity) {
+	while (true) {
+		if (interrupted.load(std::memory_order_acquire)) {
+			return -2;
+		}
+#if !defined(_WIN32)
+		// انتظار البيانات أو طلب الإيقاف
+		if (wakeFds[0] >= 0) {
+			pollfd fds[2] = { { fd, POLLIN, 0 }, { wakeFds[0], POLLIN, 0 } };
+			if (poll(fds, 2, -1) < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return -1;
+			}
+			if (fds[1].revents != 0) {
+				return -2;
+			}
+		}
+#endif
+		++syscalls;
+#if defined(_WIN32)
+		int count = _read(fd, data, static_cast<unsigned int>(std::min<size_t>(capacity, INT_MAX)));
+#else
+		ssize_t count = ::read(fd, data, capacity);
+#endif
+		if (count < 0 && interrupted.load(std::memory_order_acquire)) {
+			return -2;
+		}
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		return static_cast<long>(count);
+	}
+}
+
+ReadStatus MessageReader::readChunked(ChunkedBody& body, size_t length) {
+	body.reset(&chunkPool, length);
+
+	// البيانات المخزنة مسبقاً أولاً ثم القراءة مباشرة إلى الكتل
+	while (!body.complete()) {
+		size_t taken = framer.take(body.writableData(), body.writableSize());
+		if (taken > 0) {
+			body.commit(taken);
+			continue;
+		}
+
+		long count = readInto(body.writableData(), body.writableSize());
+		if (count == -2) {
+			return ReadStatus::INTERRUPTED;
+		}
+		if (count == 0) {
+			Logger::warn("Input closed with incomplete message (" + std::to_string(body.size()) +
+				" of " + std::to_string(length) + " bytes)");
+			return ReadStatus::END_OF_STREAM;
+		}
+		if (count < 0) {
+			if (errno == ECONNRESET || errno == EPIPE) {
+				return ReadStatus::END_OF_STREAM;
+			}
+			Logger::error("Failed to read from input: " + std::string(std::strerror(errno)));
+			return ReadStatus::READ_FAILED;
+		}
+		body.commit(static_cast<size_t>(count));
+	}
+	return ReadStatus::MESSAGE;
+}
+
+ReadStatus MessageReader::read(MessageBody& body) {
+	body.chunked = false;
+	while (true) {
+		FrameStatus status = framer.next(body.data);
+		switch (status) {
+		case FrameStatus::MESSAGE:
+			return ReadStatus::MESSAGE;
+		case FrameStatus::LARGE_MESSAGE:
+			Logger::debug("Reading large message in chunks: " + std::to_string(framer.lastLength()) + " bytes");
+			body.chunked = true;
+			return readChunked(body.chunks, framer.lastLength());
+		case FrameStatus::NEED_MORE:
+			break;
+		default:
+			reportFrameError(status, framer);
+			continue;
+		}
+
+		long count = fill();
+		if (count == -2) {
+			return ReadStatus::INTERRUPTED;
+		}
+		if (count == 0) {
+			if (framer.bufferedSize() > 0) {
+				Logger::warn("Input closed with incomplete message (" +
+					std::to_string(framer.bufferedSize()) + " bytes pending)");
+			}
+			return ReadStatus::END_OF_STREAM;
+		}
+		if (count < 0) {
+			// انقطاع الاتصال من طرف المحرر يعامل كنهاية للإدخال
+			if (errno == ECONNRESET || errno == EPIPE) {
+				return ReadStatus::END_OF_STREAM;
+			}
+			Logger::error("Failed to read from input: " + std::string(std::strerror(errno)));
+			return ReadStatus::READ_FAILED;
+		}
+	}
+}
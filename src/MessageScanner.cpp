@@ -0,0 +1,193 @@
+#include "MessageScanner.h"
+
+#include <array>
+#include <cstring>
+
+
+namespace {
+	// البايتات التي تهم تخطي الكائنات والمصفوفات
+	constexpr std::array<bool, 256> STRUCTURAL = [] {
+		std::array<bool, 256> table{};
+		for (unsigned char c : { '"', '{', '}', '[', ']' }) {
+			table[c] = true;
+		}
+		return table;
+	}();
+
+	// موضع علامة التنصيص التي تنهي نصاً يبدأ عند from (تخطي المهربة منها)
+	size_t findStringEnd(std::string_view text, size_t from) {
+		while (from < text.size()) {
+			const void* found = std::memchr(text.data() + from, '"', text.size() - from);
+			if (!found) {
+				return std::string_view::npos;
+			}
+			size_t quote = static_cast<const char*>(found) - text.data();
+			// عدد فردي من '' قبلها يعني أنها مهربة
+			size_t backslashes = 0;
+			while (quote - backslashes > from && text[quote - backslashes - 1] == '\\') {
+				++backslashes;
+			}
+			if (backslashes % 2 == 0) {
+				return quote;
+			}
+			from = quote + 1;
+		}
+		return std::string_view::npos;
+	}
+}
+
+bool MessageScanner::scan(std::string_view body, MessageHeader& header) {
+	MessageScanner scanner(body);
+	header = MessageHeader{};
+
+	scanner.skipWhitespace();
+	if (scanner.pos >= body.size() || body[scanner.pos] != '{') {
+		return false;
+	}
+	++scanner.pos;
+	scanner.skipWhitespace();
+	if (scanner.pos < body.size() && body[scanner.pos] == '}') {
+		++scanner.pos;
+	}
+	else {
+		while (true) {
+			// المفاتيح المهمة لا تحتوي على هروب؛ غيرها يُتخطى كاملاً
+			std::string_view key;
+			scanner.skipWhitespace();
+			size_t keyStart = scanner.pos;
+			if (!scanner.readPlainString(key)) {
+				scanner.pos = keyStart;
+				if (!scanner.skipString()) {
+					return false;
+				}
+				key = {};
+			}
+
+			scanner.skipWhitespace();
+			if (scanner.pos >= body.size() || body[scanner.pos] != ':') {
+				return false;
+			}
+			++scanner.pos;
+			scanner.skipWhitespace();
+
+			if (key == "method") {
+				if (!scanner.readPlainString(header.method)) {
+					return false;
+				}
+				header.hasMethod = true;
+			}
+			else if (key == "id") {
+				size_t start = scanner.pos;
+				if (!scanner.skipValue()) {
+					return false;
+				}
+				header.id = body.substr(start, scanner.pos - start);
+				header.hasId = true;
+			}
+			else if (!scanner.skipValue()) {
+				return false;
+			}
+
+			scanner.skipWhitespace();
+			if (scanner.pos >= body.size()) {
+				return false;
+			}
+			if (body[scanner.pos] == '}') {
+				++scanner.pos;
+				break;
+			}
+			if (body[scanner.pos] != ',') {
+				return false;
+			}
+			++scanner.pos;
+		}
+	}
+
+	scanner.skipWhitespace();
+	return scanner.pos == body.size();
+}
+
+void MessageScanner::skipWhitespace() {
+	while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+		++pos;
+	}
+}
+
+bool MessageScanner::readPlainString(std::string_view& value) {
+	if (pos >= text.size() || text[pos] != '"') {
+		return false;
+	}
+	size_t end = findStringEnd(text, pos + 1);
+	if (end == std::string_view::npos) {
+		return false;
+	}
+	value = text.substr(pos + 1, end - pos - 1);
+	if (value.find('\\') != std::string_view::npos) {
+		return false;
+	}
+	pos = end + 1;
+	return true;
+}
+
+bool MessageScanner::skipString() {
+	if (pos >= text.size() || text[pos] != '"') {
+		return false;
+	}
+	size_t end = findStringEnd(text, pos + 1);
+	if (end == std::string_view::npos) {
+		return false;
+	}
+	pos = end + 1;
+	return true;
+}
+
+bool MessageScanner::skipValue() {
+	if (pos >= text.size()) {
+		return false;
+	}
+	char c = text[pos];
+	if (c == '"') {
+		return skipString();
+	}
+	if (c == '{' || c == '[') {
+		return skipContainer();
+	}
+	// عدد أو true/false/null: حتى الفاصل التالي
+	size_t start = pos;
+	while (pos < text.size()) {
+		c = text[pos];
+		if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+			break;
+		}
+		++pos;
+	}
+	return pos > start;
+}
+
+bool MessageScanner::skipContainer() {
+	// عد الأقواس فقط؛ النصوص تُتخطى كي لا تُحسب أقواسها
+	int depth = 0;
+	while (pos < text.size()) {
+		while (pos < text.size() && !STRUCTURAL[static_cast<unsigned char>(text[pos])]) {
+			++pos;
+		}
+		if (pos >= text.size()) {
+			return false;
+		}
+		char c = text[pos];
+		if (c == '"') {
+			if (!skipString()) {
+				return false;
+			}
+			continue;
+		}
+		++pos;
+		if (c == '{' || c == '[') {
+			++depth;
+		}
+		else if (--depth == 0) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,240 @@
+#include "MessageWriter.h"
+#include "Logger.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+
+MessageWriter::MessageWriter(int fd) : fd(fd) {}
+
+MessageWriter::~MessageWriter() {
+	stop();
+}
+
+void MessageWriter::start() {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (running) {
+		return;
+	}
+	running = true;
+	stopping = false;
+	loopExited = false;
+	thread = std::thread(&MessageWriter::writerLoop, this);
+}
+
+void MessageWriter::stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!running) {
+			return;
+		}
+		stopping = true;
+	}
+	ready.notify_one();
+	thread.join();
+	std::lock_guard<std::mutex> lock(mutex);
+	running = false;
+}
+
+bool MessageWriter::stop(std::chrono::milliseconds timeout) {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!running) {
+			return true;
+		}
+		stopping = true;
+		ready.notify_one();
+		// قد تبقى الكتابة معلقة إذا توقف المحرر عن قراءة الأنبوب
+		if (!finished.wait_for(lock, timeout, [this] { return loopExited; })) {
+			return false;
+		}
+	}
+	stop();
+	return true;
+}
+
+bool MessageWriter::failed() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return writeFailed;
+}
+
+void MessageWriter::onFailure(std::function<void()> handler) {
+	std::lock_guard<std::mutex> lock(mutex);
+	failureHandler = std::move(handler);
+}
+
+std::string MessageWriter::acquireBuffer() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!pool.empty()) {
+			std::string buffer = std::move(pool.back());
+			pool.pop_back();
+			return buffer;
+		}
+	}
+	std::string buffer;
+	buffer.reserve(4096);
+	return buffer;
+}
+
+void MessageWriter::send(const json& message) {
+	JsonStream stream = beginMessage();
+	stream.value(message);
+	send(std::move(stream));
+}
+
+JsonStream MessageWriter::beginMessage() {
+	// حجز مساحة الرأس ثم التسلسل مباشرة بعدها في نفس المخزن
+	std::string buffer = acquireBuffer();
+	buffer.assign(HEADER_RESERVE, ' ');
+	return JsonStream(std::move(buffer));
+}
+
+void MessageWriter::send(JsonStream&& message) {
+	Frame frame;
+	frame.buffer = message.release();
+	enqueue(std::move(frame));
+}
+
+void MessageWriter::enqueue(Frame frame) {
+	// كتابة الرأس ملاصقاً لبداية المحتوى داخل المساحة المحجوزة
+	size_t length = frame.buffer.size() - HEADER_RESERVE;
+	char header[HEADER_RESERVE];
+	int headerSize = std::snprintf(header, sizeof(header), "Content-Length: %zu\r\n\r\n", length);
+	frame.offset = HEADER_RESERVE - static_cast<size_t>(headerSize);
+	std::memcpy(frame.buffer.data() + frame.offset, header, static_cast<size_t>(headerSize));
+
+	if (recorder) {
+		recorder->record(RecordDirection::OUTBOUND, std::string_view(frame.buffer).substr(HEADER_RESERVE));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.push_back(std::move(frame));
+	}
+	ready.notify_one();
+}
+
+void MessageWriter::writerLoop() {
+	Metric& batches = Metrics::get("writer.batches");
+	Metric& messages = Metrics::get("writer.messages");
+	std::vector<Frame> batch;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			ready.wait(lock, [this] { return !pending.empty() || stopping; });
+			if (pending.empty()) {
+				loopExited = true;
+				finished.notify_all();
+				return;
+			}
+			batch.swap(pending);
+		}
+
+		batches.add();
+		messages.add(static_cast<int64_t>(batch.size()));
+		int error = 0;
+		bool ok = writeBatch(batch, error);
+
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!ok && !writeFailed) {
+			writeFailed = true;
+			Logger::error("Failed to write to output: " + std::string(std::strerror(error)));
+			if (failureHandler) {
+				lock.unlock();
+				failureHandler();
+				lock.lock();
+			}
+		}
+		// إعادة المخازن إلى المجمّع مع الاحتفاظ بسعتها
+		for (Frame& frame : batch) {
+			if (pool.size() < MAX_POOLED_BUFFERS && frame.buffer.capacity() <= MAX_POOLED_CAPACITY) {
+				frame.buffer.clear();
+				pool.push_back(std::move(frame.buffer));
+			}
+		}
+		batch.clear();
+	}
+}
+
+bool MessageWriter::writeBatch(std::vector<Frame>& batch, int& error) {
+	static Metric& syscalls = Metrics::get("writer.syscalls");
+
+	if (writeFailed) {
+		return false;
+	}
+
+#if defined(_WIN32)
+	// لا يتوفر writev على ويندوز: دمج الدفعة في مخزن واحد
+	std::string joined;
+	for (const Frame& frame : batch) {
+		joined.append(frame.buffer, frame.offset, std::string::npos);
+	}
+	const char* data = joined.data();
+	size_t remaining = joined.size();
+	while (remaining > 0) {
+		syscalls.add();
+		int written = _write(fd, data, static_cast<unsigned int>(std::min<size_t>(remaining, INT_MAX)));
+		if (written < 0) {
+			error = errno;
+			return false;
+		}
+		data += written;
+		remaining -= static_cast<size_t>(written);
+	}
+	return true;
+#else
+	std::vector<iovec> vectors;
+	vectors.reserve(batch.size());
+	for (Frame& frame : batch) {
+		vectors.push_back({ frame.buffer.data() + frame.offset, frame.buffer.size() - frame.offset });
+	}
+
+	size_t index = 0;
+	while (index < vectors.size()) {
+		int count = static_cast<int>(std::min<size_t>(vectors.size() - index, IOV_MAX));
+		syscalls.add();
+		ssize_t written = ::writev(fd, vectors.data() + index, count);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			// مقبس غير حاجز ممتلئ: انتظار إمكانية الكتابة
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				pollfd output = { fd, POLLOUT, 0 };
+				if (poll(&output, 1, -1) < 0 && errno != EINTR) {
+					error = errno;
+					return false;
+				}
+				continue;
+			}
+			error = errno;
+			return false;
+		}
+
+		// تجاوز المقاطع المكتوبة بالكامل ثم تعديل المقطع الجزئي
+		size_t advance = static_cast<size_t>(written);
+		while (index < vectors.size() && advance >= vectors[index].iov_len) {
+			advance -= vectors[index].iov_len;
+			++index;
+		}
+		if (index < vectors.size()) {
+			vectors[index].iov_base = static_cast<char*>(vectors[index].iov_base) + advance;
+			vectors[index].iov_len -= advance;
+		}
+	}
+	return true;
+#endif
+}
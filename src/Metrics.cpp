@@ -0,0 +1,19 @@
+#include "Metrics.h"
+
+
+std::mutex Metrics::mutex;
+std::map<std::string, Metric> Metrics::metrics;
+
+Metric& Metrics::get(const std::string& name) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return metrics[name];
+}
+
+json Metrics::snapshot() {
+	std::lock_guard<std::mutex> lock(mutex);
+	json result = json::object();
+	for (const auto& [name, metric] : metrics) {
+		result[name] = metric.get();
+	}
+	return result;
+}
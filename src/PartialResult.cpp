@@ -0,0 +1,56 @@
+#include "PartialResult.h"
+#include "Metrics.h"
+
+
+PartialResultStream::PartialResultStream(json token, MessageWriter& writer,
+	std::chrono::milliseconds firstChunkBudget, size_t chunkSize)
+	: token(std::move(token)), writer(writer),
+	start(std::chrono::steady_clock::now()), firstChunkBudget(firstChunkBudget), chunkSize(chunkSize) {}
+
+void PartialResultStream::beginChunk() {
+	chunk = writer.beginMessage();
+	chunk.beginObject()
+		.key("jsonrpc").value("2.0")
+		.key("method").value("$/progress")
+		.key("params").beginObject()
+		.key("token").value(token)
+		.key("value").beginArray();
+}
+
+void PartialResultStream::itemAdded() {
+	if (pending >= chunkSize) {
+		flush();
+		return;
+	}
+	poll();
+}
+
+void PartialResultStream::poll() {
+	// قبل أول دفعة: لا ننتظر امتلاءها بعد انقضاء المهلة
+	if (pending > 0 && chunks == 0 && std::chrono::steady_clock::now() - start >= firstChunkBudget) {
+		flush();
+	}
+}
+
+void PartialResultStream::finish() {
+	if (pending > 0) {
+		flush();
+	}
+}
+
+void PartialResultStream::flush() {
+	static Metric& sent = Metrics::get("partial.chunks");
+	static Metric& items = Metrics::get("partial.items");
+	static Metric& firstChunk = Metrics::get("partial.first_chunk_us.max");
+
+	if (chunks == 0) {
+		firstChunk.updateMax(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - start).count());
+	}
+	items.add(static_cast<int64_t>(pending));
+	chunk.endArray().endObject().endObject();
+	writer.send(std::move(chunk));
+	pending = 0;
+	++chunks;
+	sent.add();
+}
@@ -0,0 +1,1418 @@
+// ملف مولد من src/protocol/metaModel.json بواسطة src/tools/ProtocolGen.cpp (make protocol)؛ لا يُعدل يدوياً
+#include "Protocol.h"
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+
+namespace lsp {
+namespace {
+	// القوالب معلنة مسبقاً ليجد بعضها بعضاً في الأنواع المتداخلة (std::optional<std::vector<T>>)
+	template <typename T>
+	std::enable_if_t<std::is_enum_v<T>, bool> decodeValue(json& value, T& out);
+	template <typename T>
+	std::enable_if_t<std::is_class_v<T>, bool> decodeValue(json& value, T& out);
+	template <typename T>
+	bool decodeValue(json& value, std::optional<T>& out);
+	template <typename T>
+	bool decodeValue(json& value, std::vector<T>& out);
+	template <typename T>
+	std::enable_if_t<std::is_enum_v<T>, void> encodeValue(JsonStream& out, T value);
+	template <typename T>
+	std::enable_if_t<std::is_class_v<T>, void> encodeValue(JsonStream& out, const T& value);
+	template <typename T>
+	void encodeValue(JsonStream& out, const std::optional<T>& value);
+	template <typename T>
+	void encodeValue(JsonStream& out, const std::vector<T>& value);
+
+	// النموذج قد لا يستخدم كل الأنواع الأساسية
+	[[maybe_unused]] bool decodeValue(json& value, std::string& out) {
+		if (!value.is_string()) {
+			return false;
+		}
+		out = std::move(value.get_ref<std::string&>());
+		return true;
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, int32_t& out) {
+		if (!value.is_number_integer()) {
+			return false;
+		}
+		if (value.is_number_unsigned()) {
+			uint64_t number = value.get<uint64_t>();
+			out = static_cast<int32_t>(number);
+			return number <= static_cast<uint64_t>(std::numeric_limits<int32_t>::max());
+		}
+		int64_t number = value.get<int64_t>();
+		out = static_cast<int32_t>(number);
+		return number >= std::numeric_limits<int32_t>::min() && number <= std::numeric_limits<int32_t>::max();
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, uint32_t& out) {
+		if (!value.is_number_integer()) {
+			return false;
+		}
+		// الأعداد غير السالبة تُحلل بلا إشارة، لكن json المبني برمجياً قد يحملها بإشارة
+		if (!value.is_number_unsigned() && value.get<int64_t>() < 0) {
+			return false;
+		}
+		uint64_t number = value.get<uint64_t>();
+		out = static_cast<uint32_t>(number);
+		return number <= std::numeric_limits<uint32_t>::max();
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, double& out) {
+		if (!value.is_number()) {
+			return false;
+		}
+		out = value.get<double>();
+		return true;
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, bool& out) {
+		if (!value.is_boolean()) {
+			return false;
+		}
+		out = value.get<bool>();
+		return true;
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, json& out) {
+		out = std::move(value);
+		return true;
+	}
+
+	template <typename T>
+	std::enable_if_t<std::is_enum_v<T>, bool> decodeValue(json& value, T& out) {
+		std::underlying_type_t<T> number;
+		if (!decodeValue(value, number)) {
+			return false;
+		}
+		out = static_cast<T>(number);
+		return true;
+	}
+
+	template <typename T>
+	std::enable_if_t<std::is_class_v<T>, bool> decodeValue(json& value, T& out) {
+		return decode(value, out);
+	}
+
+	template <typename T>
+	[[maybe_unused]] bool decodeValue(json& value, std::optional<T>& out) {
+		if (value.is_null()) {
+			out.reset();
+			return true;
+		}
+		return decodeValue(value, out.emplace());
+	}
+
+	template <typename T>
+	[[maybe_unused]] bool decodeValue(json& value, std::vector<T>& out) {
+		if (!value.is_array()) {
+			return false;
+		}
+		out.clear();
+		out.reserve(value.size());
+		for (json& element : value) {
+			if (!decodeValue(element, out.emplace_back())) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, const std::string& value) {
+		out.value(value);
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, int32_t value) {
+		out.value(static_cast<int64_t>(value));
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, uint32_t value) {
+		out.value(static_cast<uint64_t>(value));
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, double value) {
+		out.value(json(value));
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, bool value) {
+		out.value(value);
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, const json& value) {
+		out.value(value);
+	}
+
+	template <typename T>
+	std::enable_if_t<std::is_enum_v<T>, void> encodeValue(JsonStream& out, T value) {
+		encodeValue(out, static_cast<std::underlying_type_t<T>>(value));
+	}
+
+	template <typename T>
+	std::enable_if_t<std::is_class_v<T>, void> encodeValue(JsonStream& out, const T& value) {
+		encode(out, value);
+	}
+
+	template <typename T>
+	void encodeValue(JsonStream& out, const std::optional<T>& value) {
+		if (value) {
+			encodeValue(out, *value);
+		}
+		else {
+			out.value(nullptr);
+		}
+	}
+
+	template <typename T>
+	void encodeValue(JsonStream& out, const std::vector<T>& value) {
+		out.beginArray();
+		for (const T& element : value) {
+			encodeValue(out, element);
+		}
+		out.endArray();
+	}
+}
+
+bool decode(json& value, Position& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "line") {
+			if (!decodeValue(*member, out.line)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "character") {
+			if (!decodeValue(*member, out.character)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const Position& value) {
+	out.beginObject();
+	out.key("character");
+	encodeValue(out, value.character);
+	out.key("line");
+	encodeValue(out, value.line);
+	out.endObject();
+}
+
+bool decode(json& value, Range& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "start") {
+			if (!decodeValue(*member, out.start)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "end") {
+			if (!decodeValue(*member, out.end)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const Range& value) {
+	out.beginObject();
+	out.key("end");
+	encodeValue(out, value.end);
+	out.key("start");
+	encodeValue(out, value.start);
+	out.endObject();
+}
+
+bool decode(json& value, TextDocumentIdentifier& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "uri") {
+			if (!decodeValue(*member, out.uri)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const TextDocumentIdentifier& value) {
+	out.beginObject();
+	out.key("uri");
+	encodeValue(out, value.uri);
+	out.endObject();
+}
+
+bool decode(json& value, VersionedTextDocumentIdentifier& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "uri") {
+			if (!decodeValue(*member, out.uri)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "version") {
+			if (!decodeValue(*member, out.version)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const VersionedTextDocumentIdentifier& value) {
+	out.beginObject();
+	out.key("uri");
+	encodeValue(out, value.uri);
+	out.key("version");
+	encodeValue(out, value.version);
+	out.endObject();
+}
+
+bool decode(json& value, TextDocumentItem& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "uri") {
+			if (!decodeValue(*member, out.uri)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "languageId") {
+			if (!decodeValue(*member, out.languageId)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+		else if (key == "version") {
+			if (!decodeValue(*member, out.version)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 2;
+		}
+		else if (key == "text") {
+			if (!decodeValue(*member, out.text)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 3;
+		}
+	}
+	return (seen & 0xf) == 0xf;
+}
+
+void encode(JsonStream& out, const TextDocumentItem& value) {
+	out.beginObject();
+	out.key("languageId");
+	encodeValue(out, value.languageId);
+	out.key("text");
+	encodeValue(out, value.text);
+	out.key("uri");
+	encodeValue(out, value.uri);
+	out.key("version");
+	encodeValue(out, value.version);
+	out.endObject();
+}
+
+bool decode(json& value, TextDocumentPositionParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "textDocument") {
+			if (!decodeValue(*member, out.textDocument)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "position") {
+			if (!decodeValue(*member, out.position)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const TextDocumentPositionParams& value) {
+	out.beginObject();
+	out.key("position");
+	encodeValue(out, value.position);
+	out.key("textDocument");
+	encodeValue(out, value.textDocument);
+	out.endObject();
+}
+
+bool decode(json& value, WorkDoneProgressParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "workDoneToken") {
+			if (!(member->is_null() || member->is_number_integer() || member->is_string()) || !decodeValue(*member, out.workDoneToken)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const WorkDoneProgressParams& value) {
+	out.beginObject();
+	if (value.workDoneToken) {
+		out.key("workDoneToken");
+		encodeValue(out, *value.workDoneToken);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, PartialResultParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "partialResultToken") {
+			if (!(member->is_null() || member->is_number_integer() || member->is_string()) || !decodeValue(*member, out.partialResultToken)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const PartialResultParams& value) {
+	out.beginObject();
+	if (value.partialResultToken) {
+		out.key("partialResultToken");
+		encodeValue(out, *value.partialResultToken);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, CancelParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "id") {
+			if (!(member->is_number_integer() || member->is_string()) || !decodeValue(*member, out.id)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const CancelParams& value) {
+	out.beginObject();
+	out.key("id");
+	encodeValue(out, value.id);
+	out.endObject();
+}
+
+bool decode(json& value, DidOpenTextDocumentParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "textDocument") {
+			if (!decodeValue(*member, out.textDocument)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const DidOpenTextDocumentParams& value) {
+	out.beginObject();
+	out.key("textDocument");
+	encodeValue(out, value.textDocument);
+	out.endObject();
+}
+
+bool decode(json& value, TextDocumentContentChangeEvent& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "range") {
+			if (!decodeValue(*member, out.range)) {
+				return false;
+			}
+		}
+		else if (key == "rangeLength") {
+			if (!decodeValue(*member, out.rangeLength)) {
+				return false;
+			}
+		}
+		else if (key == "text") {
+			if (!decodeValue(*member, out.text)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 2;
+		}
+	}
+	return (seen & 0x4) == 0x4;
+}
+
+void encode(JsonStream& out, const TextDocumentContentChangeEvent& value) {
+	out.beginObject();
+	if (value.range) {
+		out.key("range");
+		encodeValue(out, *value.range);
+	}
+	if (value.rangeLength) {
+		out.key("rangeLength");
+		encodeValue(out, *value.rangeLength);
+	}
+	out.key("text");
+	encodeValue(out, value.text);
+	out.endObject();
+}
+
+bool decode(json& value, DidChangeTextDocumentParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "textDocument") {
+			if (!decodeValue(*member, out.textDocument)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "contentChanges") {
+			if (!decodeValue(*member, out.contentChanges)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const DidChangeTextDocumentParams& value) {
+	out.beginObject();
+	out.key("contentChanges");
+	encodeValue(out, value.contentChanges);
+	out.key("textDocument");
+	encodeValue(out, value.textDocument);
+	out.endObject();
+}
+
+bool decode(json& value, DidCloseTextDocumentParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "textDocument") {
+			if (!decodeValue(*member, out.textDocument)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const DidCloseTextDocumentParams& value) {
+	out.beginObject();
+	out.key("textDocument");
+	encodeValue(out, value.textDocument);
+	out.endObject();
+}
+
+bool decode(json& value, CompletionContext& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "triggerKind") {
+			if (!decodeValue(*member, out.triggerKind)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "triggerCharacter") {
+			if (!decodeValue(*member, out.triggerCharacter)) {
+				return false;
+			}
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const CompletionContext& value) {
+	out.beginObject();
+	if (value.triggerCharacter) {
+		out.key("triggerCharacter");
+		encodeValue(out, *value.triggerCharacter);
+	}
+	out.key("triggerKind");
+	encodeValue(out, value.triggerKind);
+	out.endObject();
+}
+
+bool decode(json& value, CompletionParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "textDocument") {
+			if (!decodeValue(*member, out.textDocument)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "position") {
+			if (!decodeValue(*member, out.position)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+		else if (key == "workDoneToken") {
+			if (!(member->is_null() || member->is_number_integer() || member->is_string()) || !decodeValue(*member, out.workDoneToken)) {
+				return false;
+			}
+		}
+		else if (key == "partialResultToken") {
+			if (!(member->is_null() || member->is_number_integer() || member->is_string()) || !decodeValue(*member, out.partialResultToken)) {
+				return false;
+			}
+		}
+		else if (key == "context") {
+			if (!decodeValue(*member, out.context)) {
+				return false;
+			}
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const CompletionParams& value) {
+	out.beginObject();
+	if (value.context) {
+		out.key("context");
+		encodeValue(out, *value.context);
+	}
+	if (value.partialResultToken) {
+		out.key("partialResultToken");
+		encodeValue(out, *value.partialResultToken);
+	}
+	out.key("position");
+	encodeValue(out, value.position);
+	out.key("textDocument");
+	encodeValue(out, value.textDocument);
+	if (value.workDoneToken) {
+		out.key("workDoneToken");
+		encodeValue(out, *value.workDoneToken);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, CompletionItem& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "label") {
+			if (!decodeValue(*member, out.label)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "kind") {
+			if (!decodeValue(*member, out.kind)) {
+				return false;
+			}
+		}
+		else if (key == "detail") {
+			if (!decodeValue(*member, out.detail)) {
+				return false;
+			}
+		}
+		else if (key == "documentation") {
+			if (!decodeValue(*member, out.documentation)) {
+				return false;
+			}
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const CompletionItem& value) {
+	out.beginObject();
+	if (value.detail) {
+		out.key("detail");
+		encodeValue(out, *value.detail);
+	}
+	if (value.documentation) {
+		out.key("documentation");
+		encodeValue(out, *value.documentation);
+	}
+	if (value.kind) {
+		out.key("kind");
+		encodeValue(out, *value.kind);
+	}
+	out.key("label");
+	encodeValue(out, value.label);
+	out.endObject();
+}
+
+bool decode(json& value, CompletionList& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "isIncomplete") {
+			if (!decodeValue(*member, out.isIncomplete)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "items") {
+			if (!decodeValue(*member, out.items)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const CompletionList& value) {
+	out.beginObject();
+	out.key("isIncomplete");
+	encodeValue(out, value.isIncomplete);
+	out.key("items");
+	encodeValue(out, value.items);
+	out.endObject();
+}
+
+bool decode(json& value, MarkupContent& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "kind") {
+			if (!decodeValue(*member, out.kind)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "value") {
+			if (!decodeValue(*member, out.value)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const MarkupContent& value) {
+	out.beginObject();
+	out.key("kind");
+	encodeValue(out, value.kind);
+	out.key("value");
+	encodeValue(out, value.value);
+	out.endObject();
+}
+
+bool decode(json& value, WorkspaceFolder& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "uri") {
+			if (!decodeValue(*member, out.uri)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "name") {
+			if (!decodeValue(*member, out.name)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+	}
+	return (seen & 0x3) == 0x3;
+}
+
+void encode(JsonStream& out, const WorkspaceFolder& value) {
+	out.beginObject();
+	out.key("name");
+	encodeValue(out, value.name);
+	out.key("uri");
+	encodeValue(out, value.uri);
+	out.endObject();
+}
+
+bool decode(json& value, WorkspaceFoldersInitializeParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "workspaceFolders") {
+			if (!decodeValue(*member, out.workspaceFolders)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const WorkspaceFoldersInitializeParams& value) {
+	out.beginObject();
+	if (value.workspaceFolders) {
+		out.key("workspaceFolders");
+		encodeValue(out, *value.workspaceFolders);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, InitializeParamsClientInfo& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "name") {
+			if (!decodeValue(*member, out.name)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "version") {
+			if (!decodeValue(*member, out.version)) {
+				return false;
+			}
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const InitializeParamsClientInfo& value) {
+	out.beginObject();
+	out.key("name");
+	encodeValue(out, value.name);
+	if (value.version) {
+		out.key("version");
+		encodeValue(out, *value.version);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, TextDocumentSyncClientCapabilities& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "dynamicRegistration") {
+			if (!decodeValue(*member, out.dynamicRegistration)) {
+				return false;
+			}
+		}
+		else if (key == "willSave") {
+			if (!decodeValue(*member, out.willSave)) {
+				return false;
+			}
+		}
+		else if (key == "willSaveWaitUntil") {
+			if (!decodeValue(*member, out.willSaveWaitUntil)) {
+				return false;
+			}
+		}
+		else if (key == "didSave") {
+			if (!decodeValue(*member, out.didSave)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const TextDocumentSyncClientCapabilities& value) {
+	out.beginObject();
+	if (value.didSave) {
+		out.key("didSave");
+		encodeValue(out, *value.didSave);
+	}
+	if (value.dynamicRegistration) {
+		out.key("dynamicRegistration");
+		encodeValue(out, *value.dynamicRegistration);
+	}
+	if (value.willSave) {
+		out.key("willSave");
+		encodeValue(out, *value.willSave);
+	}
+	if (value.willSaveWaitUntil) {
+		out.key("willSaveWaitUntil");
+		encodeValue(out, *value.willSaveWaitUntil);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, CompletionClientCapabilitiesCompletionItemResolveSupport& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "properties") {
+			if (!decodeValue(*member, out.properties)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const CompletionClientCapabilitiesCompletionItemResolveSupport& value) {
+	out.beginObject();
+	out.key("properties");
+	encodeValue(out, value.properties);
+	out.endObject();
+}
+
+bool decode(json& value, CompletionClientCapabilitiesCompletionItem& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "resolveSupport") {
+			if (!decodeValue(*member, out.resolveSupport)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const CompletionClientCapabilitiesCompletionItem& value) {
+	out.beginObject();
+	if (value.resolveSupport) {
+		out.key("resolveSupport");
+		encodeValue(out, *value.resolveSupport);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, CompletionClientCapabilities& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "dynamicRegistration") {
+			if (!decodeValue(*member, out.dynamicRegistration)) {
+				return false;
+			}
+		}
+		else if (key == "contextSupport") {
+			if (!decodeValue(*member, out.contextSupport)) {
+				return false;
+			}
+		}
+		else if (key == "completionItem") {
+			if (!decodeValue(*member, out.completionItem)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const CompletionClientCapabilities& value) {
+	out.beginObject();
+	if (value.completionItem) {
+		out.key("completionItem");
+		encodeValue(out, *value.completionItem);
+	}
+	if (value.contextSupport) {
+		out.key("contextSupport");
+		encodeValue(out, *value.contextSupport);
+	}
+	if (value.dynamicRegistration) {
+		out.key("dynamicRegistration");
+		encodeValue(out, *value.dynamicRegistration);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, TextDocumentClientCapabilities& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "synchronization") {
+			if (!decodeValue(*member, out.synchronization)) {
+				return false;
+			}
+		}
+		else if (key == "completion") {
+			if (!decodeValue(*member, out.completion)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const TextDocumentClientCapabilities& value) {
+	out.beginObject();
+	if (value.completion) {
+		out.key("completion");
+		encodeValue(out, *value.completion);
+	}
+	if (value.synchronization) {
+		out.key("synchronization");
+		encodeValue(out, *value.synchronization);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, GeneralClientCapabilities& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "positionEncodings") {
+			if (!decodeValue(*member, out.positionEncodings)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const GeneralClientCapabilities& value) {
+	out.beginObject();
+	if (value.positionEncodings) {
+		out.key("positionEncodings");
+		encodeValue(out, *value.positionEncodings);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, ClientCapabilities& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "textDocument") {
+			if (!decodeValue(*member, out.textDocument)) {
+				return false;
+			}
+		}
+		else if (key == "general") {
+			if (!decodeValue(*member, out.general)) {
+				return false;
+			}
+		}
+		else if (key == "experimental") {
+			if (!decodeValue(*member, out.experimental)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const ClientCapabilities& value) {
+	out.beginObject();
+	if (value.experimental) {
+		out.key("experimental");
+		encodeValue(out, *value.experimental);
+	}
+	if (value.general) {
+		out.key("general");
+		encodeValue(out, *value.general);
+	}
+	if (value.textDocument) {
+		out.key("textDocument");
+		encodeValue(out, *value.textDocument);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, InitializeParams& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "workDoneToken") {
+			if (!(member->is_null() || member->is_number_integer() || member->is_string()) || !decodeValue(*member, out.workDoneToken)) {
+				return false;
+			}
+		}
+		else if (key == "processId") {
+			if (!decodeValue(*member, out.processId)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 1;
+		}
+		else if (key == "clientInfo") {
+			if (!decodeValue(*member, out.clientInfo)) {
+				return false;
+			}
+		}
+		else if (key == "locale") {
+			if (!decodeValue(*member, out.locale)) {
+				return false;
+			}
+		}
+		else if (key == "rootPath") {
+			if (!decodeValue(*member, out.rootPath)) {
+				return false;
+			}
+		}
+		else if (key == "rootUri") {
+			if (!decodeValue(*member, out.rootUri)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 5;
+		}
+		else if (key == "capabilities") {
+			if (!decodeValue(*member, out.capabilities)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 6;
+		}
+		else if (key == "initializationOptions") {
+			if (!decodeValue(*member, out.initializationOptions)) {
+				return false;
+			}
+		}
+		else if (key == "trace") {
+			if (!decodeValue(*member, out.trace)) {
+				return false;
+			}
+		}
+		else if (key == "workspaceFolders") {
+			if (!decodeValue(*member, out.workspaceFolders)) {
+				return false;
+			}
+		}
+	}
+	return (seen & 0x62) == 0x62;
+}
+
+void encode(JsonStream& out, const InitializeParams& value) {
+	out.beginObject();
+	out.key("capabilities");
+	encodeValue(out, value.capabilities);
+	if (value.clientInfo) {
+		out.key("clientInfo");
+		encodeValue(out, *value.clientInfo);
+	}
+	if (value.initializationOptions) {
+		out.key("initializationOptions");
+		encodeValue(out, *value.initializationOptions);
+	}
+	if (value.locale) {
+		out.key("locale");
+		encodeValue(out, *value.locale);
+	}
+	out.key("processId");
+	encodeValue(out, value.processId);
+	if (value.rootPath) {
+		out.key("rootPath");
+		encodeValue(out, *value.rootPath);
+	}
+	out.key("rootUri");
+	encodeValue(out, value.rootUri);
+	if (value.trace) {
+		out.key("trace");
+		encodeValue(out, *value.trace);
+	}
+	if (value.workDoneToken) {
+		out.key("workDoneToken");
+		encodeValue(out, *value.workDoneToken);
+	}
+	if (value.workspaceFolders) {
+		out.key("workspaceFolders");
+		encodeValue(out, *value.workspaceFolders);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, InitializeResultServerInfo& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "name") {
+			if (!decodeValue(*member, out.name)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "version") {
+			if (!decodeValue(*member, out.version)) {
+				return false;
+			}
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const InitializeResultServerInfo& value) {
+	out.beginObject();
+	out.key("name");
+	encodeValue(out, value.name);
+	if (value.version) {
+		out.key("version");
+		encodeValue(out, *value.version);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, CompletionOptions& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "workDoneProgress") {
+			if (!decodeValue(*member, out.workDoneProgress)) {
+				return false;
+			}
+		}
+		else if (key == "triggerCharacters") {
+			if (!decodeValue(*member, out.triggerCharacters)) {
+				return false;
+			}
+		}
+		else if (key == "resolveProvider") {
+			if (!decodeValue(*member, out.resolveProvider)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const CompletionOptions& value) {
+	out.beginObject();
+	if (value.resolveProvider) {
+		out.key("resolveProvider");
+		encodeValue(out, *value.resolveProvider);
+	}
+	if (value.triggerCharacters) {
+		out.key("triggerCharacters");
+		encodeValue(out, *value.triggerCharacters);
+	}
+	if (value.workDoneProgress) {
+		out.key("workDoneProgress");
+		encodeValue(out, *value.workDoneProgress);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, ServerCapabilities& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "positionEncoding") {
+			if (!decodeValue(*member, out.positionEncoding)) {
+				return false;
+			}
+		}
+		else if (key == "textDocumentSync") {
+			if (!decodeValue(*member, out.textDocumentSync)) {
+				return false;
+			}
+		}
+		else if (key == "completionProvider") {
+			if (!decodeValue(*member, out.completionProvider)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const ServerCapabilities& value) {
+	out.beginObject();
+	if (value.completionProvider) {
+		out.key("completionProvider");
+		encodeValue(out, *value.completionProvider);
+	}
+	if (value.positionEncoding) {
+		out.key("positionEncoding");
+		encodeValue(out, *value.positionEncoding);
+	}
+	if (value.textDocumentSync) {
+		out.key("textDocumentSync");
+		encodeValue(out, *value.textDocumentSync);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, InitializeResult& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	uint64_t seen = 0;
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "capabilities") {
+			if (!decodeValue(*member, out.capabilities)) {
+				return false;
+			}
+			seen |= uint64_t(1) << 0;
+		}
+		else if (key == "serverInfo") {
+			if (!decodeValue(*member, out.serverInfo)) {
+				return false;
+			}
+		}
+	}
+	return (seen & 0x1) == 0x1;
+}
+
+void encode(JsonStream& out, const InitializeResult& value) {
+	out.beginObject();
+	out.key("capabilities");
+	encodeValue(out, value.capabilities);
+	if (value.serverInfo) {
+		out.key("serverInfo");
+		encodeValue(out, *value.serverInfo);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, TextDocumentSyncOptions& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "openClose") {
+			if (!decodeValue(*member, out.openClose)) {
+				return false;
+			}
+		}
+		else if (key == "change") {
+			if (!decodeValue(*member, out.change)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const TextDocumentSyncOptions& value) {
+	out.beginObject();
+	if (value.change) {
+		out.key("change");
+		encodeValue(out, *value.change);
+	}
+	if (value.openClose) {
+		out.key("openClose");
+		encodeValue(out, *value.openClose);
+	}
+	out.endObject();
+}
+
+bool decode(json& value, WorkDoneProgressOptions& out) {
+	if (!value.is_object()) {
+		return false;
+	}
+	for (auto member = value.begin(); member != value.end(); ++member) {
+		const std::string& key = member.key();
+		if (key == "workDoneProgress") {
+			if (!decodeValue(*member, out.workDoneProgress)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void encode(JsonStream& out, const WorkDoneProgressOptions& value) {
+	out.beginObject();
+	if (value.workDoneProgress) {
+		out.key("workDoneProgress");
+		encodeValue(out, *value.workDoneProgress);
+	}
+	out.endObject();
+}
+}
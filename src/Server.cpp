@@ -1,12 +1,25 @@
 #include "Server.h"
+#include "ChangeTextScanner.h"
 #include "DocManager.h"
 #include "Completion.h"
 #include "Logger.h"
+#include "MessageReader.h"
+#include "MessageScanner.h"
+#include "MethodTable.h"
+#include "Metrics.h"
+#include "PartialResult.h"
+#include "Protocol.h"
 
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
 #if defined(_WIN32)
 #define NOMINMAX
 #include <io.h>
@@ -15,15 +28,177 @@
 #include <algorithm>
 #include <stdio.h>
 #include <fcntl.h>
+#include <limits>
 
 
-DocumentManager docManager;
 Completion completionEngine;
 
-void LSPServer::sendResponse(const json& response) {
-	std::string str = response.dump();
-	std::cout << "Content-Length: " << str.size() << "\r\n\r\n" << str;
-	std::cout.flush();
+namespace {
+	// معاملات الرسالة بنوعها المولد من نموذج LSP: تحقق ونقل للحقول في مرور واحد
+	template <typename Params>
+	bool decodeParams(json& msg, Params& params) {
+		auto it = msg.find("params");
+		return it != msg.end() && lsp::decode(*it, params);
+	}
+
+	// طلب خاص بألف لقراءة مقاييس الخادم (خارج مواصفة LSP)
+	struct AlifMetricsRequest {
+		static constexpr std::string_view METHOD = "alif/metrics";
+		static constexpr bool IS_REQUEST = true;
+		using Params = void;
+	};
+
+	// رد -32600 على رسالة لا تصلح طلباً
+	json invalidRequest(const json& id, const std::string& message) {
+		return {
+			{"jsonrpc", "2.0"},
+			{"id", id},
+			{"error", {{"code", -32600}, {"message", message}}}
+		};
+	}
+
+	TextPosition toTextPosition(const lsp::Position& position) {
+		constexpr uint32_t limit = static_cast<uint32_t>(std::numeric_limits<int>::max());
+		return { static_cast<int>(std::min(position.line, limit)), static_cast<int>(std::min(position.character, limit)) };
+	}
+}
+
+// إرسال رسالة عبر خيط الكتابة (التسلسل يتم مباشرة في مخزن الإخراج)
+bool LSPServer::sendResponse(const json& response) {
+	// الطلب قد أُجيب مسبقاً (مثلاً حل محله طلب إكمال أحدث)
+	auto id = response.find("id");
+	if (id != response.end() && !pendingRequests.claim(*id)) {
+		Logger::debug("Dropping response for request already answered: " + id->dump());
+		return false;
+	}
+	if (id != response.end() && isBatched(*id)) {
+		collectBatchResponse(*id, response.dump());
+		return true;
+	}
+	writer.send(response);
+	return true;
+}
+
+bool LSPServer::sendSerializedResult(const json& id, std::string_view result) {
+	return sendStreamedResult(id, [result](JsonStream& out) { out.raw(result); });
+}
+
+bool LSPServer::sendStreamedResult(const json& id, const std::function<void(JsonStream&)>& writeResult) {
+	if (!pendingRequests.claim(id)) {
+		Logger::debug("Dropping response for request already answered: " + id.dump());
+		return false;
+	}
+
+	// نفس ترتيب المفاتيح الذي ينتجه تسلسل json
+	JsonStream response = writer.beginMessage();
+	response.beginObject().key("id").value(id).key("jsonrpc").value("2.0").key("result");
+	writeResult(response);
+	response.endObject();
+
+	// ردود الدفعة تُجمع مسلسلة كما هي لتُنسخ في مصفوفة واحدة
+	if (isBatched(id)) {
+		collectBatchResponse(id, std::string(response.text()));
+		return true;
+	}
+	writer.send(std::move(response));
+	return true;
+}
+
+bool LSPServer::collectBatchResponse(const json& id, std::string response) {
+	std::shared_ptr<BatchResponse> batch;
+	{
+		std::lock_guard<std::mutex> lock(batchesMutex);
+		auto it = batchedRequests.find(id.dump());
+		if (it == batchedRequests.end()) {
+			return false;
+		}
+		batch = std::move(it->second);
+		batchedRequests.erase(it);
+	}
+
+	std::lock_guard<std::mutex> lock(batch->mutex);
+	batch->responses.push_back(std::move(response));
+	if (--batch->remaining == 0) {
+		sendBatchResponses(*batch);
+	}
+	return true;
+}
+
+// كل ردود الدفعة في رسالة وكتابة واحدة
+void LSPServer::sendBatchResponses(const BatchResponse& batch) {
+	JsonStream message = writer.beginMessage();
+	message.beginArray();
+	for (const std::string& response : batch.responses) {
+		message.raw(response);
+	}
+	message.endArray();
+	writer.send(std::move(message));
+}
+
+bool LSPServer::isBatched(const json& id) {
+	std::lock_guard<std::mutex> lock(batchesMutex);
+	return batchedRequests.find(id.dump()) != batchedRequests.end();
+}
+
+// دفعة JSON-RPC: كل عنصر يُعالج كرسالة مستقلة (الطلبات المستقلة تعمل بالتوازي
+// على المجمّع) وتُرسل ردود الطلبات معاً؛ دفعة من الإشعارات فقط لا رد لها
+void LSPServer::handleBatch(json batch) {
+	static Metric& batches = Metrics::get("batches.received");
+	static Metric& batchedMessages = Metrics::get("batches.messages");
+
+	if (batch.empty()) {
+		writer.send(invalidRequest(nullptr, "Invalid Request: empty batch"));
+		return;
+	}
+	batches.add();
+	batchedMessages.add(static_cast<int64_t>(batch.size()));
+
+	auto collected = std::make_shared<BatchResponse>();
+	std::vector<json> messages;
+	messages.reserve(batch.size());
+	std::unordered_set<std::string> ids;
+	{
+		std::lock_guard<std::mutex> lock(batchesMutex);
+		for (json& element : batch) {
+			if (!element.is_object() || !isValidLSPMessage(element)) {
+				collected->responses.push_back(invalidRequest(nullptr, "Invalid Request").dump());
+				continue;
+			}
+			const std::string& method = element["method"].get_ref<const std::string&>();
+			const MethodEntry* entry = findMethod(method);
+			if (element.contains("id")) {
+				// معرف مكرر: رد واحد فقط ينتمي إليه، والطلب الأول يبقى مالكه
+				std::string key = element["id"].dump();
+				if (!ids.insert(key).second || batchedRequests.find(key) != batchedRequests.end()) {
+					collected->responses.push_back(invalidRequest(element["id"], "Invalid Request: duplicate id " + key).dump());
+					continue;
+				}
+				// إشعار بمعرف (ومنه $/cancelRequest) لا يُنفذ ولا رد لمعالجه، فيُرفض هنا لتكتمل الدفعة
+				if (entry && !entry->isRequest) {
+					collected->responses.push_back(invalidRequest(element["id"], "Invalid Request: " + method + " is a notification").dump());
+					pendingRequests.remove(element["id"]);
+					continue;
+				}
+				// الطرق غير المعروفة تُسجل أيضاً فردها -32601 ينتمي إلى الدفعة
+				batchedRequests.emplace(std::move(key), collected);
+				++collected->remaining;
+			}
+			// $/cancelRequest طُبق عند الاستلام
+			else if (entry && entry->execution == MethodExecution::ON_RECEIPT) {
+				continue;
+			}
+			messages.push_back(std::move(element));
+		}
+	}
+
+	if (collected->remaining == 0) {
+		if (!collected->responses.empty()) {
+			sendBatchResponses(*collected);
+		}
+	}
+	for (json& message : messages) {
+		handleMessage(std::move(message));
+	}
 }
 
 // إرسال رد خطأ وفقاً لمعايير LSP
@@ -40,66 +215,156 @@ void LSPServer::sendErrorResponse(const json& id, int code, const std::string& m
 	Logger::warn("Error response sent: " + message);
 }
 
-void LSPServer::initialize(const json& params) {
-	json capabilities = {
-		{"completionProvider", {
-			{"triggerCharacters", true}
-		}},
-		{"textDocumentSync", 1} // Full sync
+// الرد على طلب ألغاه العميل عبر $/cancelRequest
+void LSPServer::sendCancelledResponse(const json& id) {
+	static Metric& cancelled = Metrics::get("requests.cancelled");
+	bool sent = sendResponse({
+		{"jsonrpc", "2.0"},
+		{"id", id},
+		{"error", {
+			{"code", -32800},
+			{"message", "Request cancelled"}
+		}}
+	});
+	if (sent) {
+		cancelled.add();
+		Logger::debug("Request cancelled: " + id.dump());
+	}
+}
+
+void LSPServer::initialize(const lsp::InitializeParams& params, const json& id, CancellationToken) {
+	attachWorkspace(params);
+	negotiated = negotiate(params.capabilities);
+	docManager.setPositionEncoding(negotiated.positionEncoding);
+	state = ServerState::RUNNING;
+
+	lsp::InitializeResult result;
+	lsp::ServerCapabilities& capabilities = result.capabilities;
+	capabilities.positionEncoding = std::string(negotiated.positionEncoding == PositionEncoding::UTF8 ?
+		lsp::PositionEncodingKind::UTF8 : lsp::PositionEncodingKind::UTF16);
+	capabilities.textDocumentSync = json{
+		{"change", static_cast<uint32_t>(negotiated.textDocumentSync)},
+		{"openClose", true}
 	};
+	capabilities.completionProvider.emplace().resolveProvider = negotiated.completionResolve;
 
-	sendResponse({
-		{"id", 1},
-			{"result", {
-				{"capabilities", capabilities}
-			}},
-		});
+	sendStreamedResult(id, [&result](JsonStream& out) { lsp::encode(out, result); });
+	Logger::info(std::string("Negotiated position encoding ") + *capabilities.positionEncoding +
+		(negotiated.completionResolve ? ", lazy completion details" : ""));
 }
 
-void LSPServer::handleCompletion(const json& params, const json& id) {
-	// التحقق من وجود المعاملات المطلوبة
-	if (!params.contains("textDocument") || !params.contains("position")) {
-		sendErrorResponse(id, -32602, "Missing required parameters: textDocument or position");
-		return;
+NegotiatedCapabilities LSPServer::negotiate(const lsp::ClientCapabilities& client) {
+	NegotiatedCapabilities negotiated;
+
+	// UTF-16 إلزامي على كل عميل؛ UTF-8 يُختار متى عُرض ولو لم يكن الأول في تفضيل العميل
+	if (client.general && client.general->positionEncodings) {
+		for (const std::string& encoding : *client.general->positionEncodings) {
+			if (encoding == lsp::PositionEncodingKind::UTF8) {
+				negotiated.positionEncoding = PositionEncoding::UTF8;
+			}
+		}
 	}
 
-	auto textDoc = params["textDocument"];
-	auto position = params["position"];
+	if (const auto& textDocument = client.textDocument) {
+		// القائمة المختصرة تحتاج أن يكمل العميل الحقلين المحذوفين كليهما
+		if (textDocument->completion && textDocument->completion->completionItem &&
+			textDocument->completion->completionItem->resolveSupport) {
+			const auto& lazy = textDocument->completion->completionItem->resolveSupport->properties;
+			auto resolves = [&lazy](std::string_view property) {
+				return std::find(lazy.begin(), lazy.end(), property) != lazy.end();
+			};
+			negotiated.completionResolve = resolves("detail") && resolves("documentation");
+		}
+	}
+	return negotiated;
+}
 
-	// التحقق من وجود URI في مستند النص
-	if (!textDoc.contains("uri") || !textDoc["uri"].is_string()) {
-		sendErrorResponse(id, -32602, "Invalid textDocument: missing or invalid uri");
+void LSPServer::attachWorkspace(const lsp::InitializeParams& params) {
+	if (!options.indexWorkspace) {
 		return;
 	}
-
-	// التحقق من صحة معاملات الموضع
-	if (!position.contains("line") || !position.contains("character") ||
-		!position["line"].is_number_integer() || !position["character"].is_number_integer()) {
-		sendErrorResponse(id, -32602, "Invalid position: line and character must be integers");
+	// workspaceFolders أحدث من rootUri؛ يُستخدم المجلد الأول
+	std::string rootUri;
+	if (params.workspaceFolders && !params.workspaceFolders->empty()) {
+		rootUri = params.workspaceFolders->front().uri;
+	}
+	else if (params.rootUri) {
+		rootUri = *params.rootUri;
+	}
+	if (WorkspaceIndex::uriToPath(rootUri).empty()) {
 		return;
 	}
 
-	int line = position["line"].get<int>();
-	int character = position["character"].get<int>();
+	bool created = false;
+	workspace = WorkspaceIndex::acquire(rootUri, created);
+	if (created) {
+		workspace->build(pool);
+	}
+	else {
+		// الفهرس قد بُني قبل تغييرات على القرص: مسح يقارن الملفات ويحدّث ما تغير
+		Logger::info("Sharing workspace index: " + workspace->getRootUri());
+		workspace->refresh(pool);
+	}
+}
 
-	// التحقق من حدود القيم
-	if (line < 0 || character < 0) {
-		sendErrorResponse(id, -32602, "Invalid position: line and character must be non-negative");
-		return;
+AsyncTask<bool> LSPServer::findDocument(const std::string& uri, const std::function<void(const std::string&)>& reader) {
+	auto read = [&reader](const std::string& text) {
+		if (reader) {
+			reader(text);
+		}
+	};
+	// نسخة العميل تحجب النسخة المشتركة
+	if (docManager.withDocumentText(uri, read)) {
+		co_return true;
+	}
+	if (!workspace) {
+		co_return false;
 	}
+	// الفهرس ما زال يُبنى: تعليق المعالج حتى يكتمل بدل حجز الخيط
+	if (!workspace->isReady()) {
+		co_await workspace->whenReady(pool, ThreadPool::currentTaskPriority());
+	}
+	// التحقق من الوجود وحده لا يقرأ الملف من القرص
+	if (!reader) {
+		co_return workspace->contains(uri);
+	}
+	co_return workspace->withDocumentText(uri, read);
+}
 
-	std::string uri = textDoc["uri"].get<std::string>();
+AsyncTask<void> LSPServer::handleCompletion(const lsp::CompletionParams& params, const json& id, CancellationToken token) {
+	const std::string& uri = params.textDocument.uri;
 
-	// التحقق من وجود المستند في DocumentManager
-	if (!docManager.hasDocument(uri)) {
+	// الاقتراحات الحالية لا تعتمد على نص المستند: يكفي أنه معروف
+	if (!co_await findDocument(uri)) {
 		Logger::warn("Completion requested for unopened document: " + uri);
 		sendErrorResponse(id, -32603, "Document not found: " + uri);
-		return;
+		co_return;
 	}
 
 	try {
-		json result = completionEngine.getSuggestions();
-		sendResponse({ {"id", id}, {"result", result} });
+		// بث العناصر عبر $/progress إن طلب المحرر نتائج جزئية؛ الرد النهائي يبقى فارغاً
+		if (params.partialResultToken) {
+			PartialResultStream stream(*params.partialResultToken, writer);
+			bool summaries = negotiated.completionResolve;
+			bool completed = completionEngine.forEachSuggestion(token, [&stream, summaries](const CompletionSuggestion& item) {
+				stream.add([&item, summaries](JsonStream& out) { summaries ? item.writeSummary(out) : item.write(out); });
+			}, [&stream] { stream.poll(); });
+			if (!completed) {
+				sendCancelledResponse(id);
+				co_return;
+			}
+			stream.finish();
+			sendStreamedResult(id, [](JsonStream& out) { out.beginArray().endArray(); });
+			Logger::debug("Completion streamed in " + std::to_string(stream.chunksSent()) + " chunks for: " + uri);
+			co_return;
+		}
+
+		// الاقتراحات الضمنية لا تتغير: نسخ نتيجتها المسلسلة مسبقاً بدل بناء JSON لكل طلب
+		if (token.isCancelled()) {
+			sendCancelledResponse(id);
+			co_return;
+		}
+		sendSerializedResult(id, Completion::serializedBuiltins(negotiated.completionResolve));
 		Logger::debug("Completion request processed successfully for: " + uri);
 	}
 	catch (const std::exception& e) {
@@ -108,154 +373,569 @@ void LSPServer::handleCompletion(const json& params, const json& id) {
 	}
 }
 
-void LSPServer::handleMessage(const json& msg) {
+// إكمال detail وdocumentation لعنصر أُرسل مختصراً؛ العنصر غير المعروف يُعاد كما هو
+void LSPServer::handleCompletionResolve(lsp::CompletionItem& item, const json& id, CancellationToken) {
+	if (item.kind) {
+		if (const CompletionSuggestion* builtin = Completion::findBuiltin(item.label, static_cast<int>(*item.kind))) {
+			item.detail = builtin->detail;
+			item.documentation = json(builtin->documentation);
+		}
+	}
+	sendStreamedResult(id, [&item](JsonStream& out) { lsp::encode(out, item); });
+}
+
+void LSPServer::handleMessage(json msg) {
+	if (msg.is_array()) {
+		handleBatch(std::move(msg));
+		return;
+	}
+
 	// التحقق من وجود حقل method
-	if (!msg.contains("method") || !msg["method"].is_string()) {
+	auto methodField = msg.find("method");
+	if (methodField == msg.end() || !methodField->is_string()) {
 		Logger::warn("Received message without valid method field");
 		return;
 	}
 
-	std::string method = msg["method"].get<std::string>();
+	std::string method = methodField->get<std::string>();
 	Logger::debug("Processing method: " + method);
 
-	// معالجة طلب التهيئة
-	if (method == "initialize") {
-		if (!msg.contains("id")) {
-			Logger::warn("Initialize request missing id field");
-			return;
+	bool isRequest = msg.contains("id");
+	if (!checkLifecycle(method, msg)) {
+		if (isRequest) {
+			pendingRequests.remove(msg["id"]);
 		}
-		if (!msg.contains("params")) {
-			sendErrorResponse(msg["id"], -32602, "Initialize request missing params");
-			return;
+		return;
+	}
+
+	// طرق غير مدعومة: الطلبات تحتاج رداً (خاصة داخل دفعة تنتظر كل ردودها)
+	const MethodEntry* entry = findMethod(method);
+	if (!entry) {
+		Logger::debug("Unsupported method: " + method);
+		if (isRequest) {
+			sendErrorResponse(msg["id"], -32601, "Method not found: " + method);
+			pendingRequests.remove(msg["id"]);
 		}
-		initialize(msg["params"]);
+		return;
 	}
-	// معالجة فتح مستند
-	else if (method == "textDocument/didOpen") {
-		if (!msg.contains("params") || !msg["params"].contains("textDocument")) {
-			Logger::warn("didOpen request missing required parameters");
-			return;
+	if (entry->isRequest && !isRequest) {
+		Logger::warn("Request " + method + " missing id field");
+		return;
+	}
+	if (!entry->isRequest && isRequest) {
+		sendErrorResponse(msg["id"], -32600, "Invalid Request: " + method + " is a notification");
+		pendingRequests.remove(msg["id"]);
+		return;
+	}
+
+	// طرق دورة الحياة تُنفذ فوراً على خيط المعالجة للحفاظ على ترتيبها
+	if (entry->execution != MethodExecution::POOLED) {
+		// لا تعليق في هذه الطرق: تنتهي قبل عودة launch
+		launch(entry->invoke(*this, msg, CancellationToken::none()));
+		if (isRequest) {
+			pendingRequests.remove(msg["id"]);
 		}
-		auto doc = msg["params"]["textDocument"];
-		if (!doc.contains("uri") || !doc.contains("text") ||
-			!doc["uri"].is_string() || !doc["text"].is_string()) {
-			Logger::warn("didOpen request has invalid textDocument structure");
-			return;
+		return;
+	}
+
+	// بقية الرسائل تُنفذ على مجمّع الخيوط؛ رسائل المستند الواحد بالتتابع عبر سلسلته
+	std::string uri = documentUri(msg);
+	// طلبات الدفعة الواحدة مطلوبة كلها، فلا يحل أحدها محل الآخر
+	if (entry->method == lsp::CompletionRequest::METHOD && isRequest && !uri.empty() && !isBatched(msg["id"])) {
+		supersedeCompletion(uri, msg["id"]);
+	}
+	auto message = std::make_shared<json>(std::move(msg));
+	if (entry->method == lsp::DidChangeTextDocumentNotification::METHOD && !uri.empty()) {
+		postDocumentChange(uri, std::move(message));
+		return;
+	}
+	if (uri.empty()) {
+		pool.submit(track([this, message, entry] { launch(runMessage(entry, message)); }), entry->priority);
+	}
+	else {
+		postToDocument(uri, entry, std::move(message));
+	}
+}
+
+void LSPServer::supersedeCompletion(const std::string& uri, const json& id) {
+	static Metric& superseded = Metrics::get("completion.superseded");
+
+	json previous;
+	{
+		std::lock_guard<std::mutex> lock(completionsMutex);
+		json& latest = latestCompletions[uri];
+		previous = std::move(latest);
+		latest = id;
+	}
+	if (previous.is_null() || previous == id) {
+		return;
+	}
+
+	// إيقاف الحساب إن كان جارياً، ثم الرد بقائمة ناقصة ليعيد المحرر الطلب عند الحاجة
+	pendingRequests.cancel(previous);
+	bool answered = sendResponse({
+		{"jsonrpc", "2.0"},
+		{"id", previous},
+		{"result", {{"isIncomplete", true}, {"items", json::array()}}}
+	});
+	if (answered) {
+		superseded.add();
+		Logger::debug("Completion " + previous.dump() + " superseded by " + id.dump());
+	}
+}
+
+void LSPServer::finishCompletion(const std::string& uri, const json& id) {
+	std::lock_guard<std::mutex> lock(completionsMutex);
+	auto it = latestCompletions.find(uri);
+	if (it != latestCompletions.end() && it->second == id) {
+		latestCompletions.erase(it);
+	}
+}
+
+// تنفيذ رسالة على خيط عامل؛ المعالج قد يتعلق ويُستأنف لاحقاً على خيط آخر
+AsyncTask<void> LSPServer::runMessage(const MethodEntry* entry, std::shared_ptr<json> message) {
+	json& msg = *message;
+	if (!msg.contains("id")) {
+		co_await entry->invoke(*this, msg, CancellationToken::none());
+	}
+	else if (!pendingRequests.contains(msg["id"])) {
+		// أُجيب قبل أن يبدأ تنفيذه: عمل تم توفيره بالكامل
+		static Metric& skipped = Metrics::get("requests.skipped");
+		skipped.add();
+	}
+	else {
+		// الطلب قد أُلغي وهو في الطابور: الرد مباشرة دون تنفيذه
+		CancellationToken token = pendingRequests.find(msg["id"]);
+		if (token.isCancelled()) {
+			sendCancelledResponse(msg["id"]);
 		}
-		DocumentError result = docManager.openDocument(doc["uri"], doc["text"]);
-		if (result != DocumentError::SUCCESS) {
-			Logger::warn("Failed to open document " + doc["uri"].get<std::string>() +
-				": " + DocumentManager::errorToString(result));
+		else {
+			co_await entry->invoke(*this, msg, token);
 		}
+		pendingRequests.remove(msg["id"]);
 	}
-	// معالجة تحديث مستند
-	else if (method == "textDocument/didChange") {
-		if (!msg.contains("params") || !msg["params"].contains("textDocument") ||
-			!msg["params"].contains("contentChanges")) {
-			Logger::warn("didChange request missing required parameters");
-			return;
+
+	if (entry->method == lsp::CompletionRequest::METHOD && msg.contains("id")) {
+		finishCompletion(documentUri(msg), msg["id"]);
+	}
+
+	// المستند أُغلق: تحرير سلسلته إن لم تبقَ لها مهام
+	if (entry->method == lsp::DidCloseTextDocumentNotification::METHOD) {
+		releaseStrand(documentUri(msg));
+	}
+}
+
+// استخراج URI المستند الذي تخصه الرسالة (فارغ إن لم تخص مستنداً)
+std::string LSPServer::documentUri(const json& msg) {
+	auto params = msg.find("params");
+	if (params == msg.end() || !params->is_object()) {
+		return "";
+	}
+	auto textDocument = params->find("textDocument");
+	if (textDocument == params->end() || !textDocument->is_object()) {
+		return "";
+	}
+	auto uri = textDocument->find("uri");
+	if (uri == textDocument->end() || !uri->is_string()) {
+		return "";
+	}
+	return uri->get<std::string>();
+}
+
+void LSPServer::postToDocument(const std::string& uri, const MethodEntry* entry, std::shared_ptr<json> message) {
+	// المعالج قد يتعلق (انتظار الفهرس مثلاً): تحرير السلسلة حينها يسمح لتعديل لاحق
+	// بأن يسبقه، فتُحرر عند انتهائه فقط
+	// الرسالة تُعد من مهام الجلسة وهي في الطابور، ثم يعدها launch حتى انتهائها
+	ThreadPool::Task queued = track([] {});
+	Strand::SuspendableTask task = [this, entry, message, queued = std::move(queued)](Strand::Done done) {
+		launch(runMessage(entry, message), std::move(done));
+		queued();
+	};
+
+	std::lock_guard<std::mutex> lock(strandsMutex);
+	// رسالة أخرى في ذيل السلسلة: التعديلات اللاحقة لا تُدمج مع ما قبلها
+	openBatches.erase(uri);
+	auto& strand = strands[uri];
+	if (!strand) {
+		strand = std::make_shared<Strand>(pool);
+	}
+	strand->postAsync(std::move(task), entry->priority);
+}
+
+ThreadPool::Task LSPServer::track(ThreadPool::Task task) {
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+		++activeTasks;
+	}
+	return [this, task = std::move(task)] {
+		// الإنقاص يتم حتى لو رمت المهمة استثناءً
+		struct Finish {
+			LSPServer* server;
+			~Finish() { server->finishTask(); }
+		} finish{ this };
+		task();
+	};
+}
+
+void LSPServer::launch(AsyncTask<void> task, std::function<void()> onDone) {
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+		++activeTasks;
+	}
+	spawn(std::move(task), [this, onDone = std::move(onDone)] {
+		if (onDone) {
+			onDone();
 		}
-		auto doc = msg["params"]["textDocument"];
-		auto changes = msg["params"]["contentChanges"];
+		finishTask();
+	});
+}
 
-		if (!doc.contains("uri") || !doc["uri"].is_string() ||
-			!changes.is_array() || changes.empty()) {
-			Logger::warn("didChange request has invalid structure");
-			return;
+void LSPServer::finishTask() {
+	std::lock_guard<std::mutex> lock(tasksMutex);
+	if (--activeTasks == 0) {
+		tasksIdle.notify_all();
+	}
+}
+
+bool LSPServer::waitForTasks(std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lock(tasksMutex);
+	return tasksIdle.wait_for(lock, timeout, [this] { return activeTasks == 0; });
+}
+
+void LSPServer::releaseStrand(const std::string& uri) {
+	std::lock_guard<std::mutex> lock(strandsMutex);
+	auto it = strands.find(uri);
+	if (it != strands.end() && it->second->empty()) {
+		strands.erase(it);
+		openBatches.erase(uri);
+	}
+}
+
+bool LSPServer::ChangeBatch::tryAppend(const std::shared_ptr<json>& message) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (started) {
+		return false;
+	}
+	messages.push_back(message);
+	return true;
+}
+
+void LSPServer::postDocumentChange(const std::string& uri, std::shared_ptr<json> message) {
+	static Metric& coalesced = Metrics::get("didChange.coalesced");
+
+	std::lock_guard<std::mutex> lock(strandsMutex);
+	auto& batch = openBatches[uri];
+	if (batch && batch->tryAppend(message)) {
+		coalesced.add();
+		return;
+	}
+
+	batch = std::make_shared<ChangeBatch>();
+	batch->messages.push_back(std::move(message));
+	auto& strand = strands[uri];
+	if (!strand) {
+		strand = std::make_shared<Strand>(pool);
+	}
+	static const TaskPriority priority = findMethod(lsp::DidChangeTextDocumentNotification::METHOD)->priority;
+	strand->post(track([this, batch] { applyChangeBatch(batch); }), priority);
+}
+
+void LSPServer::applyChangeBatch(const std::shared_ptr<ChangeBatch>& batch) {
+	std::vector<std::shared_ptr<json>> messages;
+	{
+		std::lock_guard<std::mutex> lock(batch->mutex);
+		batch->started = true;
+		messages.swap(batch->messages);
+	}
+
+	// الدفعة تتجاوز جدول المعالجات فتفك معاملاتها هنا
+	std::vector<lsp::DidChangeTextDocumentParams> changes;
+	changes.reserve(messages.size());
+	for (const auto& message : messages) {
+		if (!decodeParams(*message, changes.emplace_back())) {
+			Logger::warn("didChange notification has invalid params");
+			changes.pop_back();
 		}
+	}
+	applyDocumentChanges(changes);
+}
 
-		if (!changes[0].contains("text") || !changes[0]["text"].is_string()) {
-			Logger::warn("didChange request has invalid content changes");
-			return;
+// تحويل contentChanges لعدة رسائل إلى قائمة تعديلات واحدة: ما قبل آخر
+// استبدال كامل للنص لا أثر له فيُحذف، والتعديلات الجزئية تُطبق بالترتيب
+void LSPServer::applyDocumentChanges(std::vector<lsp::DidChangeTextDocumentParams>& batch) {
+	std::string uri;
+	std::vector<TextChange> changes;
+
+	for (lsp::DidChangeTextDocumentParams& params : batch) {
+		if (params.contentChanges.empty()) {
+			Logger::warn("didChange notification has no content changes");
+			continue;
 		}
 
-		DocumentError result = docManager.updateDocument(doc["uri"], changes[0]["text"]);
-		if (result != DocumentError::SUCCESS) {
-			Logger::warn("Failed to update document " + doc["uri"].get<std::string>() +
-				": " + DocumentManager::errorToString(result));
+		uri = std::move(params.textDocument.uri);
+		for (lsp::TextDocumentContentChangeEvent& change : params.contentChanges) {
+			TextChange textChange;
+			if (change.range) {
+				textChange.hasRange = true;
+				textChange.start = toTextPosition(change.range->start);
+				textChange.end = toTextPosition(change.range->end);
+			}
+			else {
+				changes.clear();
+			}
+			// النص نُقل من الرسالة المحللة عند فك المعاملات دون نسخ
+			textChange.text = std::move(change.text);
+			changes.push_back(std::move(textChange));
 		}
 	}
-	// معالجة إغلاق مستند
-	else if (method == "textDocument/didClose") {
-		if (!msg.contains("params") || !msg["params"].contains("textDocument")) {
-			Logger::warn("didClose request missing required parameters");
-			return;
+
+	if (changes.empty()) {
+		return;
+	}
+
+	DocumentError result = docManager.applyChanges(uri, std::move(changes));
+	if (result != DocumentError::SUCCESS) {
+		Logger::warn("Failed to update document " + uri + ": " + DocumentManager::errorToString(result));
+	}
+}
+
+// جدول الطرق التي يعالجها الخادم: سطر لكل طريقة. إشعارات غيرها تُهمل قبل
+// تحليل محتواها، وطلبات غيرها يُرد عليها بـ -32601. الأولوية: ما ينتظره المستخدم
+// أثناء الكتابة (إكمال، تلميح، تعريف) INTERACTIVE، والتشخيص والفهرسة BACKGROUND
+const LSPServer::MethodEntry* LSPServer::findMethod(std::string_view method) {
+	static constexpr MethodTable methods(std::array{
+		handler<lsp::InitializeRequest, &LSPServer::initialize>(TaskPriority::NORMAL, MethodExecution::IMMEDIATE),
+		handler<lsp::ShutdownRequest, &LSPServer::handleShutdown>(TaskPriority::NORMAL, MethodExecution::IMMEDIATE),
+		handler<lsp::ExitNotification, &LSPServer::handleExit>(TaskPriority::NORMAL, MethodExecution::IMMEDIATE),
+		handler<AlifMetricsRequest, &LSPServer::handleMetrics>(TaskPriority::NORMAL, MethodExecution::IMMEDIATE),
+		handler<lsp::CancelNotification, &LSPServer::handleCancel>(TaskPriority::NORMAL, MethodExecution::ON_RECEIPT),
+		handler<lsp::DidOpenTextDocumentNotification, &LSPServer::handleDidOpen>(TaskPriority::NORMAL),
+		handler<lsp::DidChangeTextDocumentNotification, &LSPServer::handleDidChange>(TaskPriority::NORMAL),
+		handler<lsp::DidCloseTextDocumentNotification, &LSPServer::handleDidClose>(TaskPriority::NORMAL),
+		handler<lsp::CompletionRequest, &LSPServer::handleCompletion>(TaskPriority::INTERACTIVE),
+		handler<lsp::CompletionResolveRequest, &LSPServer::handleCompletionResolve>(TaskPriority::INTERACTIVE)
+	});
+	return methods.find(method);
+}
+
+// فك معاملات الرسالة بنوع Message ثم استدعاء المعالج؛ المعالج قد يكون روتيناً
+// مشتركاً (يُنتظر) أو دالة عادية
+template <typename Message, auto Handler>
+AsyncTask<void> LSPServer::invoke(LSPServer& server, json& msg, CancellationToken token) {
+	auto call = [&](auto&... params) {
+		if constexpr (Message::IS_REQUEST) {
+			return std::invoke(Handler, server, params..., msg["id"], token);
 		}
-		auto doc = msg["params"]["textDocument"];
-		if (!doc.contains("uri") || !doc["uri"].is_string()) {
-			Logger::warn("didClose request has invalid textDocument structure");
-			return;
+		else {
+			return std::invoke(Handler, server, params...);
 		}
-		DocumentError result = docManager.closeDocument(doc["uri"]);
-		if (result != DocumentError::SUCCESS) {
-			Logger::warn("Failed to close document " + doc["uri"].get<std::string>() +
-				": " + DocumentManager::errorToString(result));
+	};
+
+	if constexpr (std::is_void_v<typename Message::Params>) {
+		if constexpr (std::is_void_v<decltype(call())>) {
+			call();
+		}
+		else {
+			co_await call();
 		}
 	}
-	// معالجة طلب الإكمال التلقائي
-	else if (method == "textDocument/completion") {
-		if (!msg.contains("id")) {
-			Logger::warn("Completion request missing id field");
-			return;
+	else {
+		typename Message::Params params;
+		if (!decodeParams(msg, params)) {
+			if constexpr (Message::IS_REQUEST) {
+				server.sendErrorResponse(msg["id"], -32602, "Invalid params for " + std::string(Message::METHOD));
+			}
+			else {
+				Logger::warn("Invalid params for " + std::string(Message::METHOD));
+			}
+			co_return;
 		}
-		if (!msg.contains("params")) {
-			sendErrorResponse(msg["id"], -32602, "Completion request missing params");
-			return;
+		if constexpr (std::is_void_v<decltype(call(params))>) {
+			call(params);
+		}
+		else {
+			co_await call(params);
 		}
-		handleCompletion(msg["params"], msg["id"]);
 	}
-	// طرق غير مدعومة
-	else {
-		Logger::debug("Unsupported method: " + method);
+	// يبقى روتيناً مشتركاً حتى لو أسقط if constexpr كل co_await
+	co_return;
+}
+
+// طلب الإيقاف: الرد بنتيجة فارغة وانتظار إشعار exit
+void LSPServer::handleShutdown(const json& id, CancellationToken) {
+	state = ServerState::SHUTTING_DOWN;
+	sendResponse({ {"jsonrpc", "2.0"}, {"id", id}, {"result", nullptr} });
+	Logger::info("Shutdown requested");
+}
+
+// إشعار الخروج: إنهاء حلقة المعالجة
+void LSPServer::handleExit() {
+	exitRequested = true;
+	Logger::info("Exit notification received");
+}
+
+void LSPServer::handleMetrics(const json& id, CancellationToken) {
+	sendResponse({ {"jsonrpc", "2.0"}, {"id", id}, {"result", Metrics::snapshot()} });
+}
+
+// الإلغاء يُطبق فوراً عند الاستلام حتى لو كان المعالج مشغولاً
+void LSPServer::handleCancel(const lsp::CancelParams& params) {
+	bool found = pendingRequests.cancel(params.id);
+	Logger::debug("Cancel request for " + params.id.dump() + (found ? "" : " (not pending)"));
+}
+
+void LSPServer::handleDidOpen(lsp::DidOpenTextDocumentParams& params) {
+	// النص نُقل من الرسالة المحللة وينتقل إلى تخزين المستند دون نسخ
+	const std::string& uri = params.textDocument.uri;
+	DocumentError result = docManager.openDocument(uri, std::move(params.textDocument.text));
+	if (result != DocumentError::SUCCESS) {
+		Logger::warn("Failed to open document " + uri + ": " + DocumentManager::errorToString(result));
 	}
 }
 
-// التحقق من صحة بنية رسالة LSP الأساسية
-bool LSPServer::isValidLSPMessage(const json& msg) {
-	// التحقق من أن الرسالة كائن JSON
-	if (!msg.is_object()) {
-		Logger::debug("Message validation failed: not a JSON object");
-		return false;
+// didChange يصل عادة عبر دفعات postDocumentChange؛ هنا فقط إن لم يُستخرج URI مسبقاً
+void LSPServer::handleDidChange(lsp::DidChangeTextDocumentParams& params) {
+	std::vector<lsp::DidChangeTextDocumentParams> batch;
+	batch.push_back(std::move(params));
+	applyDocumentChanges(batch);
+}
+
+void LSPServer::handleDidClose(const lsp::DidCloseTextDocumentParams& params) {
+	const std::string& uri = params.textDocument.uri;
+	DocumentError result = docManager.closeDocument(uri);
+	if (result != DocumentError::SUCCESS) {
+		Logger::warn("Failed to close document " + uri + ": " + DocumentManager::errorToString(result));
 	}
+	// ما حفظه العميل قبل الإغلاق يصل إلى الفهرس المشترك لبقية الجلسات
+	if (workspace) {
+		workspace->refreshFile(uri);
+	}
+}
 
-	// التحقق من وجود حقل jsonrpc (اختياري لكن مفيد)
-	if (msg.contains("jsonrpc")) {
-		if (!msg["jsonrpc"].is_string() || msg["jsonrpc"] != "2.0") {
-			Logger::debug("Message validation failed: invalid jsonrpc version");
-			return false;
+// التحقق من أن الطريقة مسموحة في حالة الخادم الحالية
+bool LSPServer::checkLifecycle(const std::string& method, const json& msg) {
+	if (method == "exit") {
+		return true;
+	}
+
+	bool isRequest = msg.contains("id");
+
+	if (state == ServerState::UNINITIALIZED && method != "initialize") {
+		// الإشعارات قبل التهيئة تُهمل، والطلبات ترفض
+		if (isRequest) {
+			sendErrorResponse(msg["id"], -32002, "Server not initialized");
+		}
+		else {
+			Logger::debug("Dropping notification before initialize: " + method);
 		}
+		return false;
 	}
 
-	// التحقق من وجود حقل method
-	if (!msg.contains("method")) {
-		Logger::debug("Message validation failed: missing method field");
+	if (state != ServerState::UNINITIALIZED && method == "initialize") {
+		if (isRequest) {
+			sendErrorResponse(msg["id"], -32600, "Server already initialized");
+		}
 		return false;
 	}
 
-	if (!msg["method"].is_string()) {
-		Logger::debug("Message validation failed: method is not a string");
+	if (state == ServerState::SHUTTING_DOWN) {
+		if (isRequest) {
+			sendErrorResponse(msg["id"], -32600, "Server is shutting down");
+		}
+		else {
+			Logger::debug("Dropping notification after shutdown: " + method);
+		}
 		return false;
 	}
 
-	// التحقق من أن method ليس فارغاً
-	std::string method = msg["method"].get<std::string>();
-	if (method.empty()) {
-		Logger::debug("Message validation failed: empty method");
+	return true;
+}
+
+// التحقق من صحة بنية رسالة LSP الأساسية في مرور واحد على حقولها العليا
+bool LSPServer::isValidLSPMessage(const json& msg) {
+	// التحقق من أن الرسالة كائن JSON
+	if (!msg.is_object()) {
+		Logger::debug("Message validation failed: not a JSON object");
 		return false;
 	}
 
-	// التحقق من أن id موجود وصالح للطلبات التي تحتاج رد
-	if (msg.contains("id")) {
-		if (!msg["id"].is_number() && !msg["id"].is_string() && !msg["id"].is_null()) {
-			Logger::debug("Message validation failed: invalid id type");
-			return false;
+	const std::string* method = nullptr;
+	for (auto member = msg.begin(); member != msg.end(); ++member) {
+		const std::string& key = member.key();
+		// jsonrpc اختياري لكن يجب أن يكون "2.0" إن وُجد
+		if (key == "jsonrpc") {
+			if (!member->is_string() || *member != "2.0") {
+				Logger::debug("Message validation failed: invalid jsonrpc version");
+				return false;
+			}
+		}
+		else if (key == "method") {
+			if (!member->is_string()) {
+				Logger::debug("Message validation failed: method is not a string");
+				return false;
+			}
+			method = &member->get_ref<const std::string&>();
+			if (method->empty()) {
+				Logger::debug("Message validation failed: empty method");
+				return false;
+			}
+		}
+		// id الطلبات التي تحتاج رداً
+		else if (key == "id") {
+			if (!member->is_number() && !member->is_string() && !member->is_null()) {
+				Logger::debug("Message validation failed: invalid id type");
+				return false;
+			}
 		}
 	}
 
-	Logger::debug("Message validation passed for method: " + method);
+	if (!method) {
+		Logger::debug("Message validation failed: missing method field");
+		return false;
+	}
+
+	Logger::debug("Message validation passed for method: " + *method);
 	return true;
 }
 
+LSPServer::LSPServer(const ServerOptions& options)
+	: options(options), ownedPool(std::make_unique<ThreadPool>(options.workerThreads)), pool(*ownedPool),
+	input(std::make_unique<MessageReader>(0)), writer(1) {
+	input->setMaxMessageSize(options.maxMessageSize);
+	if (!options.recordFile.empty()) {
+		recorder = std::make_unique<SessionRecorder>();
+		if (recorder->open(options.recordFile)) {
+			writer.setRecorder(recorder.get());
+		}
+		else {
+			recorder.reset();
+		}
+	}
+}
+
+LSPServer::LSPServer(const ServerOptions& options, ThreadPool& sharedPool, int fd)
+	: options(options), pool(sharedPool), writer(fd) {}
+
+void LSPServer::start() {
+	writer.start();
+}
+
+bool LSPServer::finished() const {
+	return exitRequested || writer.failed();
+}
+
+void LSPServer::deliver(json msg) {
+	if (!admitMessage(msg)) {
+		return;
+	}
+	try {
+		handleMessage(std::move(msg));
+	}
+	catch (const std::exception& e) {
+		Logger::error("Unexpected error during message processing: " + std::string(e.what()));
+	}
+}
+
 int LSPServer::run() {
 #if defined(_WIN32)
 	// Set binary mode for stdin/stdout on Windows
@@ -270,117 +950,250 @@ int LSPServer::run() {
 
 	Logger::info("Alif Server Started");
 
-	while (true) {
-		// قراءة رؤوس الرسالة مع التحقق من الصحة
-		std::string line;
-		size_t length = 0;
-		bool contentLengthFound = false;
-
-		// قراءة الرؤوس حتى الوصول لسطر فارغ
-		while (std::getline(std::cin, line)) {
-			// إزالة الأحرف الإضافية من نهاية السطر
-			if (!line.empty() && line.back() == '\r') {
-				line.pop_back();
-			}
+	// انقطاع أنبوب الإخراج يعني أن المحرر لم يعد موجوداً: إيقاف القراءة أيضاً
+	writer.onFailure([this] { input->interrupt(); });
+	start();
+	pool.start();
 
-			// البحث عن رأس Content-Length
-			if (line.find("Content-Length: ") == 0) {
-				std::string lengthStr = line.substr(16);
-
-				// التحقق من صحة القيمة الرقمية
-				try {
-					length = std::stoul(lengthStr);
-					contentLengthFound = true;
-
-					// التحقق من الحدود المعقولة للرسالة
-					if (length > 1024 * 1024) { // حد أقصى 1MB
-						Logger::warn("Message too large: " + std::to_string(length) + " bytes");
-						continue; // تجاهل الرسالة الكبيرة جداً
-					}
-					if (length == 0) {
-						Logger::warn("Empty message received (Content-Length: 0)");
-						continue;
-					}
-
-					Logger::debug("Content-Length: " + std::to_string(length));
-				}
-				catch (const std::exception& e) {
-					Logger::warn("Invalid Content-Length header: " + lengthStr);
-					continue; // تجاهل الرسالة مع رأس خاطئ
-				}
-			}
+	// خيط القراءة يقطّع ويحلل الرسائل بينما يعالج الخيط الرئيسي الرسالة السابقة
+	MessageQueue queue(QUEUE_CAPACITY);
+	std::thread reader(&LSPServer::readerLoop, this, std::ref(queue));
+
+	Metric& queueDepth = Metrics::get("queue.depth");
+	Metric& queueWait = Metrics::get("queue.wait_us.total");
+	bool readerFinished = false;
+
+	while (!exitRequested) {
+		InboundMessage message;
+		queue.pop(message);
+		queueDepth.set(static_cast<int64_t>(queue.size()));
+
+		if (message.endOfStream) {
+			readerFinished = true;
+			break;
+		}
+
+		queueWait.add(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - message.receivedAt).count());
+
+		try {
+			handleMessage(std::move(message.content));
+		}
+		catch (const std::exception& e) {
+			Logger::error("Unexpected error during message processing: " + std::string(e.what()));
+		}
+
+		if (writer.failed()) {
+			Logger::error("Output closed, stopping server");
+			break;
+		}
+	}
+
+	int exitCode = drain(queue, readerFinished);
+	reader.join();
+	Logger::info("Server metrics: " + Metrics::snapshot().dump());
+	return exitCode;
+}
+
+void LSPServer::flushRecorder() {
+	if (recorder) {
+		recorder->flush();
+	}
+}
 
-			// نهاية الرؤوس
-			if (line.empty()) {
+int LSPServer::drain(MessageQueue& queue, bool readerFinished) {
+	// إيقاف خيط القراءة وتجاهل الرسائل التي لم تُعالج بعد
+	if (!readerFinished) {
+		input->interrupt();
+		size_t dropped = 0;
+		InboundMessage message;
+		while (true) {
+			queue.pop(message);
+			if (message.endOfStream) {
 				break;
 			}
+			++dropped;
+		}
+		if (dropped > 0) {
+			Logger::info("Dropped " + std::to_string(dropped) + " pending messages on exit");
 		}
+	}
 
-		// التحقق من وجود رأس Content-Length
-		if (!contentLengthFound) {
-			Logger::warn("Message received without Content-Length header");
-			continue;
+	// إنهاء المهام الجارية، ثم إلغاؤها إن تجاوزت المهلة
+	if (!waitForTasks(DRAIN_TIMEOUT)) {
+		Logger::warn("In-flight work did not finish in time, cancelling " +
+			std::to_string(pendingRequests.size()) + " pending requests");
+		pendingRequests.cancelAll();
+		if (!waitForTasks(DRAIN_TIMEOUT)) {
+			Logger::error("Worker tasks still running after cancellation, terminating");
+			flushRecorder();
+			std::_Exit(state == ServerState::SHUTTING_DOWN ? 0 : 1);
 		}
+	}
+	pool.stop();
 
-		// قراءة محتوى الرسالة مع الحماية من الأخطاء
-		std::vector<char> buffer(length);
-		std::cin.read(buffer.data(), length);
+	// الخروج بالرمز 0 فقط إذا سبق طلب shutdown
+	int exitCode = state == ServerState::SHUTTING_DOWN ? 0 : 1;
+	if (exitCode != 0) {
+		Logger::warn("Exiting without shutdown request");
+	}
 
-		// التحقق من نجاح القراءة
-		if (!std::cin) {
-			Logger::error("Failed to read message body (" + std::to_string(length) + " bytes)");
-			// محاولة استعادة الحالة
-			std::cin.clear();
-			continue;
+	if (!writer.stop(DRAIN_TIMEOUT)) {
+		// المحرر لا يقرأ الإخراج: لا ننتظر إلى الأبد
+		Logger::error("Timed out flushing pending output, terminating");
+		flushRecorder();
+		std::_Exit(exitCode);
+	}
+	return exitCode;
+}
+
+// حلقة خيط القراءة: تقطيع الرسائل وتحليلها ثم دفعها إلى الطابور
+void LSPServer::readerLoop(MessageQueue& queue) {
+	Metric& queueDepth = Metrics::get("queue.depth");
+	Metric& queueDepthMax = Metrics::get("queue.depth.max");
+
+	MessageBody body;
+
+	while (true) {
+		ReadStatus status = input->read(body);
+		if (status != ReadStatus::MESSAGE) {
+			if (status == ReadStatus::END_OF_STREAM) {
+				Logger::info("Input stream closed, stopping server");
+			}
+			else if (status == ReadStatus::INTERRUPTED) {
+				Logger::debug("Reader stopped");
+			}
+			else {
+				Logger::error("Fatal Error: Cannot read from stdin");
+			}
+			InboundMessage end;
+			end.endOfStream = true;
+			queue.push(std::move(end));
+			return;
+		}
+
+		if (recorder) {
+			recorder->record(RecordDirection::INBOUND, body);
 		}
 
-		// التحقق من قراءة البيانات كاملة
-		size_t bytesRead = std::cin.gcount();
-		if (bytesRead != length) {
-			Logger::warn("Incomplete message read: expected " + std::to_string(length) +
-				" bytes, got " + std::to_string(bytesRead));
+		InboundMessage message;
+		if (!parseMessage(body, message.content) || !admitMessage(message.content)) {
 			continue;
 		}
+		message.receivedAt = std::chrono::steady_clock::now();
+		queue.push(std::move(message));
 
-		// تحليل JSON مع معالجة محسنة للأخطاء
-		try {
-			// التحقق من أن البيانات ليست فارغة
-			if (buffer.empty()) {
-				Logger::warn("Empty message buffer received");
-				continue;
-			}
+		int64_t depth = static_cast<int64_t>(queue.size());
+		queueDepth.set(depth);
+		queueDepthMax.updateMax(depth);
+	}
+}
 
-			// تحليل JSON
-			json msg = json::parse(buffer.begin(), buffer.end());
+bool LSPServer::parseMessage(const MessageBody& body, json& content) {
+	static Metric& received = Metrics::get("messages.received");
+	static Metric& chunkedMessages = Metrics::get("messages.chunked");
+	static Metric& skipped = Metrics::get("messages.skipped_unparsed");
+	static Metric& fastChanges = Metrics::get("didChange.fast_path");
 
-			// التحقق من أن الرسالة تحتوي على حقول أساسية
-			if (msg.is_null() || (!msg.is_object())) {
-				Logger::warn("Invalid JSON structure: not an object");
-				continue;
+	Logger::debug("Content-Length: " + std::to_string(body.size()));
+
+	// المرحلة الأولى: مسح method وid فقط؛ إشعار لطريقة لا نعالجها (مثل $/setTrace
+	// وأحداث مساحة العمل) يُهمل دون بناء params. الرسائل المقسمة كبيرة ويُتوقع أن تكون مستندات
+	MessageHeader header;
+	bool scanned = !body.chunked && MessageScanner::scan(body.data, header);
+	if (scanned && header.hasMethod && !header.hasId && !findMethod(header.method)) {
+		Logger::debug("Ignoring unsupported notification: " + std::string(header.method));
+		received.add();
+		skipped.add();
+		return false;
+	}
+
+	// تحليل JSON مع معالجة محسنة للأخطاء
+	try {
+		// didChange: نصوص التعديلات تُفك بالمتجهات خارج المحلل ويُحلل ما بقي فقط.
+		// أي فشل (ومنه JSON غير صالح) يعود إلى التحليل الكامل ليُبلغ عن الخطأ كالمعتاد
+		bool parsed = false;
+		if (body.chunked || (scanned && header.method == "textDocument/didChange")) {
+			ChangeTexts changes;
+			if (ChangeTextScanner::extract(body, changes)) {
+				content = json::parse(changes.skeleton, nullptr, false);
+				parsed = !content.is_discarded() && ChangeTextScanner::restore(content, changes.texts);
 			}
+			if (parsed) {
+				fastChanges.add();
+			}
+		}
 
-			// التحقق من صحة رسالة LSP
-			if (!isValidLSPMessage(msg)) {
-				Logger::warn("Invalid LSP message structure received");
-				continue;
+		// تحليل JSON مباشرة من المخزن المؤقت دون نسخ، أو تدفقياً عبر الكتل للرسائل الكبيرة
+		if (body.chunked) {
+			if (!parsed) {
+				content = json::parse(body.chunks.begin(), body.chunks.end());
 			}
+			chunkedMessages.add();
+		}
+		else if (!parsed) {
+			content = json::parse(body.data.data(), body.data.data() + body.data.size());
+		}
 
-			Logger::debug("Message parsed successfully");
-			handleMessage(msg);
+		// دفعة JSON-RPC: تُتحقق عناصرها عند تنفيذها
+		if (content.is_array()) {
+			Logger::debug("Batch parsed successfully (" + std::to_string(content.size()) + " messages)");
+			received.add();
+			return true;
 		}
-		catch (const json::parse_error& e) {
-			// خطأ في تحليل JSON مع تفاصيل أكثر
-			Logger::error("JSON Parse Error at byte " + std::to_string(e.byte) +
-				": " + std::string(e.what()));
 
-			// إظهار جزء من البيانات المشكوكة للتشخيص
-			std::string preview(buffer.begin(), buffer.begin() + std::min(size_t(100), buffer.size()));
-			Logger::debug("Message preview: " + preview + (buffer.size() > 100 ? "..." : ""));
+		// التحقق من أن الرسالة تحتوي على حقول أساسية
+		if (content.is_null() || (!content.is_object())) {
+			Logger::warn("Invalid JSON structure: not an object");
+			return false;
 		}
-		catch (const std::exception& e) {
-			Logger::error("Unexpected error during message processing: " + std::string(e.what()));
+
+		// التحقق من صحة رسالة LSP
+		if (!isValidLSPMessage(content)) {
+			Logger::warn("Invalid LSP message structure received");
+			return false;
+		}
+
+		Logger::debug("Message parsed successfully");
+		received.add();
+		return true;
+	}
+	catch (const json::parse_error& e) {
+		// خطأ في تحليل JSON مع تفاصيل أكثر
+		Logger::error("JSON Parse Error at byte " + std::to_string(e.byte) +
+			": " + std::string(e.what()));
+
+		// إظهار جزء من البيانات المشكوكة للتشخيص
+		std::string preview(body.preview(100));
+		Logger::debug("Message preview: " + preview + (body.size() > 100 ? "..." : ""));
+	}
+	catch (const std::exception& e) {
+		Logger::error("Unexpected error during message parsing: " + std::string(e.what()));
+	}
+	return false;
+}
+
+bool LSPServer::admitMessage(json& content) {
+	if (content.is_array()) {
+		for (json& element : content) {
+			if (element.is_object() && element.contains("method")) {
+				admitMessage(element);
+			}
 		}
+		return true;
 	}
 
-	return 0;
+	// طرق الاستلام ($/cancelRequest) تُنفذ هنا وتُستهلك رسالتها؛ بمعرف تمضي
+	// لتُرفض بـ -32600 كأي إشعار أُرسل بمعرف
+	auto methodField = content.find("method");
+	const MethodEntry* entry = methodField != content.end() && methodField->is_string()
+		? findMethod(methodField->get_ref<const std::string&>()) : nullptr;
+	if (entry && entry->execution == MethodExecution::ON_RECEIPT && !content.contains("id")) {
+		launch(entry->invoke(*this, content, CancellationToken::none()));
+		return false;
+	}
+	if (content.contains("id")) {
+		pendingRequests.add(content["id"]);
+	}
+	return true;
 }
@@ -0,0 +1,102 @@
+#include "SessionRecorder.h"
+#include "Logger.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+
+
+SessionRecorder::~SessionRecorder() {
+	close();
+}
+
+bool SessionRecorder::open(const std::string& path) {
+	std::lock_guard<std::mutex> lock(mutex);
+	file = std::fopen(path.c_str(), "wb");
+	if (!file) {
+		Logger::error("Cannot open recording file " + path + ": " + std::strerror(errno));
+		return false;
+	}
+	std::setvbuf(file, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+	start = std::chrono::steady_clock::now();
+	Logger::info("Recording session to " + path);
+	return true;
+}
+
+void SessionRecorder::close() {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (file) {
+		std::fclose(file);
+		file = nullptr;
+	}
+}
+
+void SessionRecorder::flush() {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (file) {
+		std::fflush(file);
+	}
+}
+
+void SessionRecorder::writeHeader(RecordDirection direction, size_t length) {
+	int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start).count();
+	std::fprintf(file, "%s %" PRId64 " %zu\r\n", direction == RecordDirection::INBOUND ? "in" : "out",
+		elapsed, length);
+}
+
+void SessionRecorder::record(RecordDirection direction, std::string_view body) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!file) {
+		return;
+	}
+	writeHeader(direction, body.size());
+	std::fwrite(body.data(), 1, body.size(), file);
+	std::fputs("\r\n", file);
+}
+
+void SessionRecorder::record(RecordDirection direction, const MessageBody& body) {
+	if (!body.chunked) {
+		record(direction, std::string_view(body.data.data(), body.data.size()));
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!file) {
+		return;
+	}
+	writeHeader(direction, body.size());
+	for (size_t i = 0; i < body.chunks.segmentCount(); ++i) {
+		std::string_view segment = body.chunks.segment(i);
+		std::fwrite(segment.data(), 1, segment.size(), file);
+	}
+	std::fputs("\r\n", file);
+}
+
+bool SessionRecorder::readEntry(std::FILE* file, Entry& entry) {
+	char direction[4] = {};
+	int64_t timestamp = 0;
+	size_t length = 0;
+	if (std::fscanf(file, "%3s %" SCNd64 " %zu", direction, &timestamp, &length) != 3) {
+		return false;
+	}
+	if (std::fgetc(file) != '\r' || std::fgetc(file) != '\n') {
+		return false;
+	}
+
+	if (std::strcmp(direction, "in") == 0) {
+		entry.direction = RecordDirection::INBOUND;
+	}
+	else if (std::strcmp(direction, "out") == 0) {
+		entry.direction = RecordDirection::OUTBOUND;
+	}
+	else {
+		return false;
+	}
+	entry.timestamp = timestamp;
+	entry.body.resize(length);
+	if (std::fread(entry.body.data(), 1, length, file) != length) {
+		return false;
+	}
+	return std::fgetc(file) == '\r' && std::fgetc(file) == '\n';
+}
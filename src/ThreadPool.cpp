@@ -0,0 +1,338 @@
+#include "ThreadPool.h"
+#include "Logger.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <string>
+
+
+namespace {
+	// المجمّع الذي ينتمي إليه الخيط الحالي وفهرسه فيه (nullptr خارج المجمّعات)
+	thread_local const ThreadPool* currentPool = nullptr;
+	thread_local size_t currentIndex = 0;
+
+	// مقاييس زمن الانتظار في الطابور لكل فئة
+	struct PriorityMetrics {
+		Metric& waitTotal;
+		Metric& waitMax;
+		Metric& tasks;
+	};
+
+	PriorityMetrics& metricsFor(TaskPriority priority) {
+		static PriorityMetrics metrics[TASK_PRIORITY_COUNT] = {
+			{ Metrics::get("scheduler.interactive.wait_us.total"), Metrics::get("scheduler.interactive.wait_us.max"),
+				Metrics::get("scheduler.interactive.tasks") },
+			{ Metrics::get("scheduler.normal.wait_us.total"), Metrics::get("scheduler.normal.wait_us.max"),
+				Metrics::get("scheduler.normal.tasks") },
+			{ Metrics::get("scheduler.background.wait_us.total"), Metrics::get("scheduler.background.wait_us.max"),
+				Metrics::get("scheduler.background.tasks") }
+		};
+		return metrics[static_cast<size_t>(priority)];
+	}
+}
+
+thread_local TaskPriority ThreadPool::currentPriority = TaskPriority::NORMAL;
+
+const char* priorityToString(TaskPriority priority) {
+	switch (priority) {
+	case TaskPriority::INTERACTIVE: return "interactive";
+	case TaskPriority::NORMAL: return "normal";
+	case TaskPriority::BACKGROUND: return "background";
+	default: return "unknown";
+	}
+}
+
+ThreadPool::ThreadPool(size_t threadCount) {
+	if (threadCount == 0) {
+		threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+	}
+	for (size_t i = 0; i < threadCount; ++i) {
+		workers.push_back(std::make_unique<Worker>());
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	stop();
+}
+
+void ThreadPool::start() {
+	std::lock_guard<std::mutex> lock(sleepMutex);
+	if (running) {
+		return;
+	}
+	running = true;
+	stopping = false;
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+	}
+	Logger::debug("Thread pool started with " + std::to_string(workers.size()) + " workers");
+}
+
+void ThreadPool::stop() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		if (!running) {
+			return;
+		}
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto& worker : workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+	std::lock_guard<std::mutex> lock(sleepMutex);
+	running = false;
+}
+
+void ThreadPool::submit(Task task, TaskPriority priority) {
+	size_t index = currentPool == this
+		? currentIndex
+		: nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+	size_t level = static_cast<size_t>(priority);
+
+	{
+		std::lock_guard<std::mutex> lock(workers[index]->mutex);
+		workers[index]->tasks[level].push_back({ std::move(task), priority, Clock::now() });
+	}
+	queuedByPriority[level].fetch_add(1, std::memory_order_release);
+	queuedTasks.fetch_add(1, std::memory_order_release);
+
+	// القفل يمنع فقدان الإشعار بين فحص الشرط والنوم
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wake.notify_one();
+}
+
+bool ThreadPool::shouldYield() {
+	if (currentPool == nullptr || currentPriority == TaskPriority::INTERACTIVE) {
+		return false;
+	}
+	for (size_t level = 0; level < static_cast<size_t>(currentPriority); ++level) {
+		if (currentPool->queuedByPriority[level].load(std::memory_order_acquire) > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ThreadPool::popFrom(Worker& worker, size_t level, bool newest, QueuedTask& task) {
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	auto& tasks = worker.tasks[level];
+	if (tasks.empty()) {
+		return false;
+	}
+	if (newest) {
+		task = std::move(tasks.back());
+		tasks.pop_back();
+	}
+	else {
+		task = std::move(tasks.front());
+		tasks.pop_front();
+	}
+	return true;
+}
+
+bool ThreadPool::takeStarvedTask(QueuedTask& task) {
+	auto now = Clock::now();
+	for (size_t level = TASK_PRIORITY_COUNT - 1; level > 0; --level) {
+		if (queuedByPriority[level].load(std::memory_order_acquire) == 0) {
+			continue;
+		}
+		for (auto& worker : workers) {
+			std::lock_guard<std::mutex> lock(worker->mutex);
+			auto& tasks = worker->tasks[level];
+			// مقدمة الطابور هي الأقدم
+			if (!tasks.empty() && now - tasks.front().enqueuedAt > STARVATION_LIMIT[level]) {
+				task = std::move(tasks.front());
+				tasks.pop_front();
+				static Metric& promotions = Metrics::get("scheduler.starvation_promotions");
+				promotions.add();
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool ThreadPool::takeTask(size_t index, QueuedTask& task) {
+	if (takeStarvedTask(task)) {
+		return true;
+	}
+
+	for (size_t level = 0; level < TASK_PRIORITY_COUNT; ++level) {
+		if (queuedByPriority[level].load(std::memory_order_acquire) == 0) {
+			continue;
+		}
+		if (popFrom(*workers[index], level, true, task)) {
+			return true;
+		}
+		for (size_t offset = 1; offset < workers.size(); ++offset) {
+			if (popFrom(*workers[(index + offset) % workers.size()], level, false, task)) {
+				static Metric& steals = Metrics::get("pool.steals");
+				steals.add();
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void ThreadPool::runTask(QueuedTask& task) {
+	PriorityMetrics& metrics = metricsFor(task.priority);
+	int64_t waited = std::chrono::duration_cast<std::chrono::microseconds>(
+		Clock::now() - task.enqueuedAt).count();
+	metrics.waitTotal.add(waited);
+	metrics.waitMax.updateMax(waited);
+	metrics.tasks.add();
+
+	currentPriority = task.priority;
+	try {
+		task.task();
+	}
+	catch (const std::exception& e) {
+		Logger::error("Unhandled exception in worker task: " + std::string(e.what()));
+	}
+	task.task = nullptr;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+	currentPool = this;
+	currentIndex = index;
+
+	QueuedTask task;
+	while (true) {
+		if (takeTask(index, task)) {
+			queuedByPriority[static_cast<size_t>(task.priority)].fetch_sub(1, std::memory_order_acq_rel);
+			queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+			runTask(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wake.wait(lock, [this] {
+			return stopping || queuedTasks.load(std::memory_order_acquire) > 0;
+		});
+		if (stopping) {
+			return;
+		}
+	}
+}
+
+void Strand::post(ThreadPool::Task task, TaskPriority priority) {
+	std::lock_guard<std::mutex> lock(mutex);
+	tasks.push_back({ std::move(task), nullptr, priority });
+	if (!running) {
+		schedule(priority);
+	}
+}
+
+void Strand::postAsync(SuspendableTask task, TaskPriority priority) {
+	std::lock_guard<std::mutex> lock(mutex);
+	tasks.push_back({ nullptr, std::move(task), priority });
+	if (!running) {
+		schedule(priority);
+	}
+}
+
+// يُستدعى والقفل محجوز: جدولة تصريف جديد إذا لم يوجد تصريف بأولوية مساوية أو أعلى
+void Strand::schedule(TaskPriority priority) {
+	if (scheduled && scheduledPriority <= priority) {
+		return;
+	}
+	scheduled = true;
+	scheduledPriority = priority;
+	pool.submit([self = shared_from_this()] { self->drain(); }, priority);
+}
+
+bool Strand::empty() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return tasks.empty();
+}
+
+void Strand::drain() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// تصريف آخر يعمل أو سبق أن أفرغ السلسلة
+		if (running || tasks.empty()) {
+			return;
+		}
+		running = true;
+		scheduled = false;
+	}
+
+	for (size_t processed = 0; processed < MAX_BATCH; ++processed) {
+		StrandTask task;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (tasks.empty()) {
+				break;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		ThreadPool::currentPriority = task.priority;
+		if (task.asyncTask) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				asyncState = AsyncState::CALLING;
+			}
+			bool failed = false;
+			try {
+				task.asyncTask([self = shared_from_this()] { self->finishAsync(); });
+			}
+			catch (const std::exception& e) {
+				Logger::error("Unhandled exception in strand task: " + std::string(e.what()));
+				failed = true;
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			// انتهت فوراً (أو رمت فلن تستدعي done): المتابعة إلى المهمة التالية
+			if (failed || asyncState != AsyncState::CALLING) {
+				asyncState = AsyncState::NONE;
+				continue;
+			}
+			// تعلقت: التصريف ينتهي هنا ويبقى running حتى تستدعي done
+			asyncState = AsyncState::SUSPENDED;
+			return;
+		}
+		try {
+			task.task();
+		}
+		catch (const std::exception& e) {
+			Logger::error("Unhandled exception in strand task: " + std::string(e.what()));
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	release();
+}
+
+void Strand::finishAsync() {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (asyncState == AsyncState::CALLING) {
+		// التصريف الذي استدعاها يتابع بنفسه
+		asyncState = AsyncState::FINISHED;
+		return;
+	}
+	if (asyncState != AsyncState::SUSPENDED) {
+		return;
+	}
+	asyncState = AsyncState::NONE;
+	release();
+}
+
+void Strand::release() {
+	// ما زالت هناك مهام: إعادة الجدولة بأولوية أهمها بدل احتكار الخيط
+	running = false;
+	if (tasks.empty()) {
+		return;
+	}
+	TaskPriority highest = TaskPriority::BACKGROUND;
+	for (const StrandTask& pending : tasks) {
+		highest = std::min(highest, pending.priority);
+	}
+	scheduled = false;
+	schedule(highest);
+}
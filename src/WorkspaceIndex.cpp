@@ -0,0 +1,356 @@
+#include "WorkspaceIndex.h"
+#include "Logger.h"
+#include "Metrics.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+
+namespace {
+	// فهرس لكل مجلد جذر ما دامت جلسة تستخدمه أو مسح يعمل عليه؛ يُحرر مع آخرهما
+	// فلا تتراكم في الخادم الدائم مساحات عمل لم يعد يفتحها أحد
+	std::mutex registryMutex;
+	std::map<std::string, std::weak_ptr<WorkspaceIndex>> registry;
+
+	int hexValue(char c) {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	bool isUnreserved(unsigned char c) {
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+			c == '-' || c == '.' || c == '_' || c == '~' || c == '/';
+	}
+
+	// ملفات مصدر ألف التي يشملها الفهرس
+	bool isSourceFile(const std::filesystem::path& path) {
+		return path.extension() == ".alif";
+	}
+
+	// مجلدات لا تحتوي على مصادر المشروع: المخفية (.git وغيرها) ومخرجات البناء والحزم
+	bool isSkippedDirectory(const std::string& name) {
+		static constexpr std::string_view skipped[] = {
+			"build", "out", "bin", "obj", "node_modules", "__pycache__"
+		};
+		if (!name.empty() && name[0] == '.') {
+			return true;
+		}
+		for (std::string_view directory : skipped) {
+			if (name == directory) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+std::shared_ptr<WorkspaceIndex> WorkspaceIndex::acquire(const std::string& rootUri, bool& created) {
+	static Metric& indexes = Metrics::get("workspace.indexes");
+	static Metric& shared = Metrics::get("workspace.shared_attaches");
+
+	std::string key = pathToUri(uriToPath(rootUri));
+	std::lock_guard<std::mutex> lock(registryMutex);
+	// حذف مداخل الفهارس التي حُررت
+	for (auto it = registry.begin(); it != registry.end();) {
+		it = it->second.expired() ? registry.erase(it) : std::next(it);
+	}
+	std::shared_ptr<WorkspaceIndex> index = registry[key].lock();
+	created = !index;
+	if (created) {
+		index = std::make_shared<WorkspaceIndex>(key);
+		registry[key] = index;
+		indexes.add();
+	}
+	else {
+		shared.add();
+	}
+	return index;
+}
+
+std::string WorkspaceIndex::uriToPath(const std::string& uri) {
+	const std::string scheme = "file://";
+	if (uri.rfind(scheme, 0) != 0) {
+		return "";
+	}
+
+	std::string path;
+	path.reserve(uri.size() - scheme.size());
+	for (size_t i = scheme.size(); i < uri.size(); ++i) {
+		if (uri[i] == '%' && i + 2 < uri.size() && hexValue(uri[i + 1]) >= 0 && hexValue(uri[i + 2]) >= 0) {
+			path += static_cast<char>(hexValue(uri[i + 1]) * 16 + hexValue(uri[i + 2]));
+			i += 2;
+		}
+		else {
+			path += uri[i];
+		}
+	}
+
+	// مسارات ويندوز: file:///c:/dir تصبح c:/dir
+	if (path.size() >= 3 && path[0] == '/' && path[2] == ':') {
+		path.erase(0, 1);
+	}
+	// إزالة الشرطة الأخيرة من المجلدات
+	while (path.size() > 1 && path.back() == '/') {
+		path.pop_back();
+	}
+	return path;
+}
+
+std::string WorkspaceIndex::pathToUri(const std::string& path) {
+	static const char* digits = "0123456789ABCDEF";
+
+	std::string uri = "file://";
+	if (!path.empty() && path[0] != '/') {
+		uri += '/';
+	}
+	for (char c : path) {
+		unsigned char byte = static_cast<unsigned char>(c == '\\' ? '/' : c);
+		if (isUnreserved(byte)) {
+			uri += static_cast<char>(byte);
+		}
+		else {
+			uri += '%';
+			uri += digits[byte >> 4];
+			uri += digits[byte & 0xF];
+		}
+	}
+	return uri;
+}
+
+struct WorkspaceIndex::Scan {
+	std::filesystem::recursive_directory_iterator it;
+	std::error_code error;
+	// بلغ المسح MAX_FILES فتوقف قبل آخر المجلد
+	bool truncated = false;
+	size_t recorded = 0;
+	size_t yields = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+WorkspaceIndex::WorkspaceIndex(const std::string& rootUri)
+	: rootUri(rootUri), rootPath(uriToPath(rootUri)) {}
+
+WorkspaceIndex::~WorkspaceIndex() = default;
+
+void WorkspaceIndex::build(ThreadPool& pool) {
+	startScan(pool);
+}
+
+void WorkspaceIndex::refresh(ThreadPool& pool) {
+	static Metric& refreshes = Metrics::get("workspace.refreshes");
+
+	// البناء الأول ما زال يعمل: سيقرأ الملفات بحالتها الحالية
+	if (!isReady()) {
+		return;
+	}
+	refreshes.add();
+	startScan(pool);
+}
+
+void WorkspaceIndex::startScan(ThreadPool& pool) {
+	namespace fs = std::filesystem;
+	// مسح واحد في كل لحظة؛ المسح الجاري يرى حالة القرص الأحدث
+	if (scanning.exchange(true, std::memory_order_acq_rel)) {
+		return;
+	}
+	scan = std::make_unique<Scan>();
+	generation.fetch_add(1, std::memory_order_acq_rel);
+
+	if (rootPath.empty() || !fs::is_directory(rootPath, scan->error)) {
+		Logger::warn("Workspace root is not a local directory: " + rootUri);
+		scan.reset();
+		scanning.store(false, std::memory_order_release);
+		markReady();
+		return;
+	}
+	scan->it = fs::recursive_directory_iterator(rootPath, fs::directory_options::skip_permission_denied, scan->error);
+
+	// المهمة تحمل الفهرس: تكتمل ولو انتهت الجلسة التي بدأتها
+	pool.submit([self = shared_from_this(), &pool] { self->continueScan(pool); }, TaskPriority::BACKGROUND);
+}
+
+void WorkspaceIndex::continueScan(ThreadPool& pool) {
+	static Metric& buildTime = Metrics::get("workspace.index_ms.total");
+	static Metric& yields = Metrics::get("workspace.scan_yields");
+
+	namespace fs = std::filesystem;
+	fs::recursive_directory_iterator& it = scan->it;
+	while (!scan->error && it != fs::recursive_directory_iterator()) {
+		const fs::directory_entry& entry = *it;
+		std::error_code entryError;
+
+		if (entry.is_directory(entryError)) {
+			if (isSkippedDirectory(entry.path().filename().string())) {
+				it.disable_recursion_pending();
+			}
+		}
+		else if (isSourceFile(entry.path())) {
+			if (getFileCount() >= MAX_FILES) {
+				scan->truncated = true;
+				break;
+			}
+			if (recordFile(entry.path())) {
+				++scan->recorded;
+			}
+		}
+		it.increment(scan->error);
+
+		// نقطة استباق بين الملفات: الطلبات التفاعلية لا تنتظر نهاية الفهرسة
+		if (ThreadPool::shouldYield()) {
+			yields.add();
+			++scan->yields;
+			pool.submit([self = shared_from_this(), &pool] { self->continueScan(pool); }, TaskPriority::BACKGROUND);
+			return;
+		}
+	}
+	if (scan->error) {
+		Logger::warn("Workspace scan stopped early: " + scan->error.message());
+	}
+	if (scan->truncated) {
+		Logger::warn("Workspace scan stopped at " + std::to_string(MAX_FILES) + " files: " + rootUri);
+	}
+	// مسح مبتور لا يثبت حذف ما لم يصل إليه
+	size_t removed = scan->error || scan->truncated ? 0 : removeUnseen();
+
+	size_t recorded = scan->recorded;
+	size_t yielded = scan->yields;
+	int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - scan->start).count();
+	scan.reset();
+	scanning.store(false, std::memory_order_release);
+	buildTime.add(elapsed);
+	markReady();
+	Logger::info("Workspace indexed: " + rootUri + " (" + std::to_string(recorded) + " files recorded, " +
+		std::to_string(removed) + " removed, " + std::to_string(elapsed) + " ms, " + std::to_string(yielded) + " yields)");
+}
+
+bool WorkspaceIndex::recordFile(const std::filesystem::path& path) {
+	static Metric& files = Metrics::get("workspace.files");
+
+	namespace fs = std::filesystem;
+	std::error_code error;
+	FileStamp stamp;
+	stamp.size = fs::file_size(path, error);
+	if (!error) {
+		stamp.modified = fs::last_write_time(path, error);
+	}
+	if (error || !fs::is_regular_file(path, error) || stamp.size > MAX_FILE_SIZE) {
+		return false;
+	}
+	stamp.generation = generation.load(std::memory_order_acquire);
+
+	std::string uri = pathToUri(path.generic_string());
+	std::lock_guard<std::mutex> lock(stampsMutex);
+	auto known = stamps.find(uri);
+	// الملف لم يتغير منذ تسجيله: يكفي تأكيد وجوده في هذا الجيل
+	if (known != stamps.end() && known->second.size == stamp.size && known->second.modified == stamp.modified) {
+		known->second.generation = stamp.generation;
+		return false;
+	}
+	stamps[uri] = stamp;
+	files.add();
+	return true;
+}
+
+bool WorkspaceIndex::contains(const std::string& uri) const {
+	std::string key = pathToUri(uriToPath(uri));
+	std::lock_guard<std::mutex> lock(stampsMutex);
+	return stamps.find(key) != stamps.end();
+}
+
+size_t WorkspaceIndex::getFileCount() const {
+	std::lock_guard<std::mutex> lock(stampsMutex);
+	return stamps.size();
+}
+
+bool WorkspaceIndex::readFile(const std::string& uri, std::string& text) const {
+	static Metric& reads = Metrics::get("workspace.file_reads");
+
+	if (!contains(uri)) {
+		return false;
+	}
+	std::ifstream file(uriToPath(uri), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	std::ostringstream content;
+	content << file.rdbuf();
+	text = std::move(content).str();
+	reads.add();
+	return true;
+}
+
+size_t WorkspaceIndex::removeUnseen() {
+	uint64_t current = generation.load(std::memory_order_acquire);
+	size_t removed = 0;
+	std::lock_guard<std::mutex> lock(stampsMutex);
+	for (auto it = stamps.begin(); it != stamps.end();) {
+		if (it->second.generation == current) {
+			++it;
+			continue;
+		}
+		it = stamps.erase(it);
+		++removed;
+	}
+	return removed;
+}
+
+void WorkspaceIndex::refreshFile(const std::string& uri) {
+	namespace fs = std::filesystem;
+	if (!isReady()) {
+		return;
+	}
+	fs::path path = uriToPath(uri);
+	std::error_code error;
+	fs::path relative = path.lexically_relative(rootPath);
+	if (!isSourceFile(path) || relative.empty() || *relative.begin() == "..") {
+		return;
+	}
+	for (const fs::path& part : relative.parent_path()) {
+		if (isSkippedDirectory(part.string())) {
+			return;
+		}
+	}
+
+	if (fs::exists(path, error)) {
+		recordFile(path);
+		return;
+	}
+	// حُذف من القرص
+	std::string key = pathToUri(path.generic_string());
+	std::lock_guard<std::mutex> lock(stampsMutex);
+	stamps.erase(key);
+}
+
+bool WorkspaceIndex::addWaiter(std::coroutine_handle<> handle, ThreadPool& pool, TaskPriority priority) {
+	static Metric& suspended = Metrics::get("workspace.suspended_waiters");
+
+	std::lock_guard<std::mutex> lock(waitersMutex);
+	if (isReady()) {
+		return false;
+	}
+	waiters.push_back({ handle, &pool, priority });
+	suspended.add();
+	return true;
+}
+
+void WorkspaceIndex::markReady() {
+	std::vector<Waiter> resumed;
+	{
+		std::lock_guard<std::mutex> lock(waitersMutex);
+		ready.store(true, std::memory_order_release);
+		resumed.swap(waiters);
+	}
+	for (const Waiter& waiter : resumed) {
+		waiter.pool->submit([handle = waiter.handle] { handle.resume(); }, waiter.priority);
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include "Logger.h"
+
+// روتين مشترك (coroutine) كسول يعيد قيمة من النوع T. لا يبدأ حتى يُنتظر عبر
+// co_await أو يُطلق عبر spawn، ويستأنف منتظِره مباشرة عند انتهائه.
+// المعالج المعلق لا يحجز خيط عمل: يُستأنف على مجمّع الخيوط عند جاهزية ما ينتظره.
+// نقطة التعليق الوحيدة حالياً هي اكتمال فهرس مساحة العمل (WorkspaceIndex::whenReady)؛
+// قراءة نص المستند قفل قراءة قصير، وقراءة الملفات من القرص تبقى متزامنة على خيط العامل
+template <typename T = void>
+class AsyncTask;
+
+namespace detail {
+	// عند الانتهاء: الانتقال إلى الروتين المنتظِر دون تعميق المكدس
+	struct FinalAwaiter {
+		bool await_ready() noexcept { return false; }
+		template <typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+			std::coroutine_handle<> continuation = handle.promise().continuation;
+			return continuation ? continuation : std::noop_coroutine();
+		}
+		void await_resume() noexcept {}
+	};
+
+	struct PromiseBase {
+		std::coroutine_handle<> continuation;
+		std::exception_ptr exception;
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void unhandled_exception() { exception = std::current_exception(); }
+	};
+
+	template <typename T>
+	struct Promise : PromiseBase {
+		std::optional<T> value;
+
+		AsyncTask<T> get_return_object();
+		void return_value(T result) { value = std::move(result); }
+		T take() {
+			if (exception) {
+				std::rethrow_exception(exception);
+			}
+			return std::move(*value);
+		}
+	};
+
+	template <>
+	struct Promise<void> : PromiseBase {
+		AsyncTask<void> get_return_object();
+		void return_void() {}
+		void take() {
+			if (exception) {
+				std::rethrow_exception(exception);
+			}
+		}
+	};
+}
+
+template <typename T>
+class AsyncTask {
+public:
+	using promise_type = detail::Promise<T>;
+	using Handle = std::coroutine_handle<promise_type>;
+
+	explicit AsyncTask(Handle handle) : handle(handle) {}
+	AsyncTask(AsyncTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	AsyncTask& operator=(AsyncTask&& other) noexcept {
+		if (this != &other) {
+			if (handle) {
+				handle.destroy();
+			}
+			handle = std::exchange(other.handle, nullptr);
+		}
+		return *this;
+	}
+	AsyncTask(const AsyncTask&) = delete;
+	AsyncTask& operator=(const AsyncTask&) = delete;
+	~AsyncTask() {
+		if (handle) {
+			handle.destroy();
+		}
+	}
+
+	// انتظار المهمة: تبدأ الآن وتستأنف المنتظِر عند انتهائها
+	auto operator co_await() && noexcept {
+		struct Awaiter {
+			Handle handle;
+			bool await_ready() noexcept { return !handle || handle.done(); }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+				handle.promise().continuation = awaiting;
+				return handle;
+			}
+			T await_resume() { return handle.promise().take(); }
+		};
+		return Awaiter{ handle };
+	}
+
+private:
+	Handle handle;
+};
+
+namespace detail {
+	template <typename T>
+	AsyncTask<T> Promise<T>::get_return_object() {
+		return AsyncTask<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+	}
+
+	inline AsyncTask<void> Promise<void>::get_return_object() {
+		return AsyncTask<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+	}
+
+	// روتين يبدأ فوراً ويتلف نفسه عند انتهائه (أساس spawn)
+	struct Detached {
+		struct promise_type {
+			Detached get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept {}
+		};
+	};
+
+	inline Detached runDetached(AsyncTask<void> task, std::function<void()> onDone) {
+		try {
+			co_await std::move(task);
+		}
+		catch (const std::exception& e) {
+			Logger::error("Unhandled exception in async task: " + std::string(e.what()));
+		}
+		catch (...) {
+			Logger::error("Unhandled non-standard exception in async task");
+		}
+		if (onDone) {
+			onDone();
+		}
+	}
+}
+
+// تشغيل مهمة دون انتظارها: تعمل على الخيط الحالي حتى أول تعليق، ثم على
+// الخيط الذي يستأنفها. onDone يُستدعى عند انتهائها حتى لو رمت استثناءً
+inline void spawn(AsyncTask<void> task, std::function<void()> onDone = nullptr) {
+	detail::runDetached(std::move(task), std::move(onDone));
+}
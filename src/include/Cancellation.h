@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "Json.h"
+
+// رمز إلغاء تعاوني - تفحصه المعالجات عند نقاط آمنة
+class CancellationToken {
+public:
+	CancellationToken() : state(std::make_shared<std::atomic<bool>>(false)) {}
+
+	bool isCancelled() const { return state->load(std::memory_order_acquire); }
+	void cancel() const { state->store(true, std::memory_order_release); }
+
+	// رمز لا يُلغى أبداً (للإشعارات)
+	static const CancellationToken& none();
+
+private:
+	std::shared_ptr<std::atomic<bool>> state;
+};
+
+// جدول الطلبات الجارية مع رموز إلغائها، مفهرس بمعرف الطلب
+class RequestTable {
+public:
+	// تسجيل طلب جديد وإرجاع رمز إلغائه
+	CancellationToken add(const json& id);
+	// إلغاء طلب جارٍ؛ يعيد false إذا لم يكن موجوداً (انتهى أو لم يصل)
+	bool cancel(const json& id);
+	// الحصول على رمز طلب مسجل (أو رمز غير ملغى إن لم يوجد)
+	CancellationToken find(const json& id) const;
+	// إزالة الطلب بعد إرسال رده
+	void remove(const json& id);
+	// إزالة الطلب إن كان جارياً؛ من ينجح في ذلك هو وحده من يرسل الرد
+	bool claim(const json& id);
+	bool contains(const json& id) const;
+	// إلغاء كل الطلبات الجارية (عند الخروج)
+	void cancelAll();
+	size_t size() const;
+
+private:
+	mutable std::mutex mutex;
+	std::unordered_map<std::string, CancellationToken> requests;
+
+	// المعرف قد يكون رقماً أو نصاً؛ التسلسل يميز بينهما
+	static std::string key(const json& id) { return id.dump(); }
+};
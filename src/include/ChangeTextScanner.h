@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Json.h"
+#include "MessageReader.h"
+
+// رسالة didChange بعد فصل نصوص تعديلاتها
+struct ChangeTexts {
+	// الرسالة كما هي مع استبدال كل نص تعديل بـ ""
+	std::string skeleton;
+	// نصوص contentChanges مفكوكة الهروب، بترتيب عناصرها
+	std::vector<std::string> texts;
+};
+
+// مسار سريع لرسائل didChange: النص الكامل للمستند (معظمه عربي متعدد البايتات)
+// هو أغلب الرسالة، فيُفك بالمتجهات مباشرة إلى السلسلة التي تُنقل إلى تخزين المستند،
+// ويُحلل ما بقي منها (بضع مئات من البايتات) بمحلل JSON المعتاد. يعمل على المحتوى
+// المتصل والمقسم على كتل. أي شكل غير متوقع يعيد false ليحلل المستدعي الرسالة كاملة
+class ChangeTextScanner {
+public:
+	static bool extract(const MessageBody& body, ChangeTexts& result);
+	// إعادة النصوص إلى الرسالة المحللة من skeleton (نقلاً دون نسخ)
+	static bool restore(json& message, std::vector<std::string>& texts);
+
+private:
+	ChangeTextScanner(std::vector<std::string_view> segments, ChangeTexts& result);
+
+	std::vector<std::string_view> segments;
+	ChangeTexts& result;
+	size_t segment = 0;
+	size_t pos = 0;
+
+	bool atEnd();
+	char peek();
+	// استهلاك البايت الحالي ونسخه إلى skeleton
+	void advance();
+	void skipWhitespace();
+	bool expect(char c);
+	// قراءة نص؛ decoded يستقبل قيمته (أو nullptr للتخطي)، وcopy ينسخ محتواه إلى skeleton
+	bool scanString(std::string* decoded, bool copy);
+	// طول النص الذي يبدأ عند الموضع الحالي حتى علامة إغلاقه، دون استهلاكه
+	size_t quotedLength();
+	bool skipValue();
+	// قراءة كائن؛ member يُستدعى لكل مفتاح مفكوك ليقرأ قيمته
+	template <typename Member>
+	bool scanObject(Member&& member);
+	bool scanMessage();
+	bool scanParams(bool& hasChanges);
+	bool scanChanges();
+	bool scanChange();
+};
@@ -1,11 +1,36 @@
 #pragma once
+#include <functional>
 #include <vector>
 #include <string>
-#include "json.hpp"
+#include <string_view>
+#include "Json.h"
+#include "JsonStream.h"
+#include "Cancellation.h"
 
-using json = nlohmann::json;
+// عنصر إكمال واحد (CompletionItem في LSP)
+struct CompletionSuggestion {
+	std::string label{};
+	int kind{};  // LSP CompletionItemKind
+	std::string detail{};
+	std::string documentation{};
+
+	// كتابة العنصر ككائن JSON مباشرة في مخزن الإخراج
+	void write(JsonStream& out) const;
+	// العنصر دون detail وdocumentation لعميل يكملهما بـ completionItem/resolve
+	void writeSummary(JsonStream& out) const;
+};
 
 class Completion {
 public:
-	json getSuggestions();
+	// كتابة نتيجة الإكمال كاملة (CompletionList)؛ تعيد false إذا أُلغي الطلب.
+	// summaries: عناصر مختصرة (writeSummary) لعميل يكمل تفاصيلها عند الحاجة
+	bool writeSuggestions(JsonStream& out, const CancellationToken& token = CancellationToken::none(), bool summaries = false);
+	// تمرير الاقتراحات واحداً تلو الآخر إلى emit (للبث الجزئي)؛ تعيد false إذا أُلغي الطلب.
+	// step يُستدعى في كل خطوة من الحلقة ولو لم يُمرر فيها عنصر (مثلاً PartialResultStream::poll)
+	bool forEachSuggestion(const CancellationToken& token, const std::function<void(const CompletionSuggestion&)>& emit,
+		const std::function<void()>& step = nullptr);
+	// نتيجة الاقتراحات الضمنية مسلسلة مرة واحدة؛ ثابتة طوال عمر العملية
+	static const std::string& serializedBuiltins(bool summaries = false);
+	// الاقتراح الضمني بهذا الاسم والنوع لإكمال تفاصيله؛ nullptr إن لم يوجد
+	static const CompletionSuggestion* findBuiltin(std::string_view label, int kind);
 };
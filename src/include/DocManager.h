@@ -1,6 +1,9 @@
 #pragma once
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 // أنواع الأخطاء المحتملة في إدارة المستندات
 enum class DocumentError {
@@ -12,23 +15,59 @@ enum class DocumentError {
 	OPERATION_FAILED
 };
 
+// وحدة أعمدة المواضع المتفق عليها مع العميل في initialize
+enum class PositionEncoding {
+	UTF16,  // الافتراضي في LSP: عدّ الحروف حتى العمود
+	UTF8    // العمود إزاحة بالبايت داخل السطر فلا تحويل
+};
+
+// موضع في المستند (السطر والعمود بوحدات ترميز المواضع المتفق عليه)
+struct TextPosition {
+	int line = 0;
+	int character = 0;
+};
+
+// تعديل واحد على نص المستند؛ بدون نطاق يعني استبدال النص كاملاً
+struct TextChange {
+	bool hasRange = false;
+	TextPosition start{};
+	TextPosition end{};
+	std::string text{};
+};
+
+// مدير المستندات - آمن للاستخدام من عدة خيوط (قراءات متزامنة، كتابة حصرية)
 class DocumentManager {
 public:
 	// إدارة المستندات مع معالجة الأخطاء
-	DocumentError openDocument(const std::string& uri, const std::string& text);
-	DocumentError updateDocument(const std::string& uri, const std::string& text);
+	// النص يُنقل إلى التخزين؛ مرره بـ std::move لتجنب نسخه
+	DocumentError openDocument(const std::string& uri, std::string text);
+	// تطبيق سلسلة تعديلات بالترتيب تحت قفل واحد (نصوص الاستبدال الكامل تُنقل)
+	DocumentError applyChanges(const std::string& uri, std::vector<TextChange> changes);
 	DocumentError closeDocument(const std::string& uri);
+	// تُضبط مرة واحدة عند التهيئة قبل أي تعديل
+	void setPositionEncoding(PositionEncoding encoding) { positionEncoding = encoding; }
 	
-	// الحصول على نص المستند مع التحقق من الوجود
-	std::string getDocumentText(const std::string& uri) const;
-	bool hasDocument(const std::string& uri) const;
+	// قراءة نص المستند دون نسخه: reader يُستدعى بمرجع للنص المخزن تحت قفل القراءة.
+	// يعيد false إن لم يوجد المستند. لا تُستدعى دوال التعديل من داخل reader
+	template <typename Reader>
+	bool withDocumentText(const std::string& uri, Reader&& reader) const {
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		auto it = documents.find(uri);
+		if (it == documents.end()) {
+			return false;
+		}
+		reader(static_cast<const std::string&>(it->second));
+		return true;
+	}
 	size_t getDocumentCount() const;
 	
 	// تحويل رمز الخطأ إلى رسالة نصية
 	static std::string errorToString(DocumentError error);
 
 private:
+	mutable std::shared_mutex mutex;
 	std::unordered_map<std::string, std::string> documents;
+	PositionEncoding positionEncoding = PositionEncoding::UTF16;
 	
 	// التحقق من صحة URI
 	bool isValidURI(const std::string& uri) const;
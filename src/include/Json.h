@@ -0,0 +1,5 @@
+#pragma once
+#include "json.hpp"
+
+// نوع JSON المستخدم في الخادم
+using json = nlohmann::json;
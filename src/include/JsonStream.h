@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "Json.h"
+
+// مسلسل JSON تدفقي: يكتب القيم في مخزن نصي مباشرة دون بناء شجرة json.
+// الفواصل تُضاف تلقائياً؛ على المستدعي موازنة begin/end وكتابة key قبل كل قيمة
+// داخل كائن. الناتج مطابق لتسلسل json (دون مسافات ودون هروب غير ASCII)
+class JsonStream {
+public:
+	// الكتابة تُلحق بما في المخزن (مثلاً مساحة رأس محجوزة)
+	explicit JsonStream(std::string buffer = {});
+
+	JsonStream& beginObject();
+	JsonStream& endObject();
+	JsonStream& beginArray();
+	JsonStream& endArray();
+	JsonStream& key(std::string_view name);
+
+	JsonStream& value(std::string_view text);
+	JsonStream& value(const char* text) { return value(std::string_view(text)); }
+	JsonStream& value(const std::string& text) { return value(std::string_view(text)); }
+	JsonStream& value(bool flag);
+	JsonStream& value(int number) { return value(static_cast<int64_t>(number)); }
+	JsonStream& value(int64_t number);
+	JsonStream& value(uint64_t number);
+	JsonStream& value(std::nullptr_t);
+	JsonStream& value(const json& node);
+	// قيمة مسلسلة مسبقاً تُنسخ كما هي
+	JsonStream& raw(std::string_view serialized);
+
+	// ما كُتب منذ الإنشاء (دون محتوى المخزن الأولي)
+	std::string_view text() const { return std::string_view(out).substr(start); }
+	// المخزن كاملاً بما فيه المحتوى الأولي
+	std::string release() { return std::move(out); }
+
+private:
+	std::string out;
+	size_t start = 0;
+	// القيمة أو المفتاح التالي يحتاج فاصلة قبله
+	bool needComma = false;
+
+	void separate();
+	void writeString(std::string_view text);
+};
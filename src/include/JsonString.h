@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// فك ترميز نص JSON (ما بعد علامة التنصيص الافتتاحية) تدفقياً عبر مقاطع متتالية.
+// المقاطع الخالية من الهروب تُمسح بتعليمات المتجهات (AVX2 أو SSE2) وتُنسخ دفعة واحدة،
+// وتسلسلات الهروب تُفك حتى لو انقسمت بين مقطعين. يرفض ما يرفضه محلل nlohmann:
+// بايتات التحكم، الهروب غير الصالح، وأنصاف أزواج UTF-16 المنفردة
+class JsonStringDecoder {
+public:
+	enum class Status {
+		DONE,        // وُجدت علامة التنصيص الختامية
+		NEED_MORE,   // انتهى المقطع قبل نهاية النص
+		INVALID
+	};
+
+	// output فارغ يعني التخطي فقط (دون فك الهروب أو التحقق منه)
+	explicit JsonStringDecoder(std::string* output) : output(output) {}
+
+	// متابعة الفك من مقطع جديد؛ consumed عدد البايتات المستهلكة منه (شاملة الختامية)
+	Status feed(std::string_view input, size_t& consumed);
+
+	// موضع أول '"' أو '\' أو بايت تحكم في المدى (أو size إن لم يوجد)
+	static size_t findSpecial(const char* data, size_t size);
+	// هل النص UTF-8 سليم (كما يشترطه محلل JSON في النصوص)
+	static bool isValidUtf8(std::string_view text);
+
+private:
+	std::string* output;
+	// تسلسل هروب لم يكتمل بعد (أطوله \uXXXX\uXXXX)
+	char escape[12] = {};
+	size_t escapeSize = 0;
+
+	// إضافة بايت إلى تسلسل الهروب الجاري وفكه إن اكتمل
+	bool pushEscape(char c);
+	void appendCodePoint(unsigned codePoint);
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MessageReader.h"
+#include "Server.h"
+#include "ThreadPool.h"
+
+// عنوان استماع الخادم: مقبس يونكس أو منفذ TCP على الواجهة المحلية فقط
+struct ListenAddress {
+	enum class Kind {
+		UNIX = 0,
+		TCP
+	};
+
+	Kind kind = Kind::UNIX;
+	std::string path;     // مسار مقبس يونكس
+	uint16_t port = 0;    // منفذ TCP (0 = يختاره النظام)
+
+	// تحليل "unix:<path>" أو "tcp:<port>"
+	static bool parse(const std::string& text, ListenAddress& address);
+	std::string toString() const;
+};
+
+// خادم الاستماع - حلقة أحداث epoll واحدة تقبل الاتصالات وتقطّع رسائلها
+// بقراءات غير حاجزة، وتسلم كل اتصال إلى جلسة LSPServer مستقلة.
+// الجلسات تشارك مجمّع خيوط واحداً ويبقى الخادم يعمل بعد انقطاع عملائه
+class ListenServer {
+public:
+	ListenServer(const ServerOptions& options, const ListenAddress& address);
+	~ListenServer();
+
+	ListenServer(const ListenServer&) = delete;
+	ListenServer& operator=(const ListenServer&) = delete;
+
+	// حلقة الأحداث حتى SIGINT أو SIGTERM
+	int run();
+
+private:
+	static constexpr int MAX_EVENTS = 64;
+	static constexpr size_t READ_CHUNK = 64 * 1024;
+	// مهلة إنهاء مهام الجلسة المغلقة قبل إلغاء طلباتها
+	static constexpr std::chrono::milliseconds CLOSE_TIMEOUT{ 2000 };
+	// فترة فحص الجلسات المغلقة التي ما زالت لها مهام جارية
+	static constexpr int CLOSING_POLL_MS = 20;
+
+	struct Connection {
+		int fd = -1;
+		MessageFramer framer;
+		// محتوى الرسالة الحالية؛ الرسائل الكبيرة تتجمع في كتله عبر عدة قراءات
+		MessageBody body;
+		bool readingLarge = false;
+		std::unique_ptr<LSPServer> session;
+		// وقت الإغلاق وهل أُلغيت الطلبات المعلقة
+		std::chrono::steady_clock::time_point closedAt{};
+		bool cancelled = false;
+	};
+
+	ServerOptions options;
+	ListenAddress address;
+	ThreadPool pool;
+	ChunkPool chunkPool;
+	int listenFd = -1;
+	int epollFd = -1;
+	int signalFd = -1;
+	std::unordered_map<int, std::unique_ptr<Connection>> connections;
+	// اتصالات مغلقة بانتظار انتهاء مهام جلساتها وكتابة ردودها
+	std::vector<std::unique_ptr<Connection>> closing;
+
+	bool openListener();
+	void acceptConnections();
+	// قراءة المتاح من الاتصال ومعالجة الرسائل المكتملة؛ يعيد false إذا انتهى الاتصال
+	bool readConnection(Connection& connection);
+	bool processFrames(Connection& connection);
+	void closeConnection(int fd);
+	// إتلاف الجلسات المغلقة التي انتهت مهامها؛ wait لانتظارها جميعاً عند الإيقاف
+	void reapClosing(bool wait);
+	void finishConnection(Connection& connection);
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Json.h"
+
+// طابور محدود السعة بدون أقفال (خوارزمية Vyukov)
+// يدعم عدة منتجين ومستهلكاً واحداً أو أكثر، مع انتظار عند الامتلاء أو الفراغ
+template<typename T>
+class BoundedQueue {
+public:
+	explicit BoundedQueue(size_t requestedCapacity) {
+		size_t capacity = 2;
+		while (capacity < requestedCapacity) {
+			capacity <<= 1;
+		}
+		mask = capacity - 1;
+		cells = std::make_unique<Cell[]>(capacity);
+		for (size_t i = 0; i < capacity; ++i) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+	// محاولة الإضافة دون انتظار؛ تعيد false إذا كان الطابور ممتلئاً
+	bool tryPush(T&& value) {
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		while (true) {
+			Cell& cell = cells[pos & mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+			if (diff == 0) {
+				if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					cell.value = std::move(value);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					pushed.fetch_add(1, std::memory_order_release);
+					pushed.notify_one();
+					return true;
+				}
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// محاولة السحب دون انتظار؛ تعيد false إذا كان الطابور فارغاً
+	bool tryPop(T& value) {
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		while (true) {
+			Cell& cell = cells[pos & mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+			if (diff == 0) {
+				if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					value = std::move(cell.value);
+					cell.sequence.store(pos + mask + 1, std::memory_order_release);
+					popped.fetch_add(1, std::memory_order_release);
+					popped.notify_one();
+					return true;
+				}
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// إضافة مع الانتظار حتى يتوفر مكان (ضغط عكسي على المنتج)
+	void push(T&& value) {
+		while (true) {
+			uint32_t seen = popped.load(std::memory_order_acquire);
+			if (tryPush(std::move(value))) {
+				return;
+			}
+			popped.wait(seen, std::memory_order_acquire);
+		}
+	}
+
+	// سحب مع الانتظار حتى تتوفر رسالة
+	void pop(T& value) {
+		while (true) {
+			uint32_t seen = pushed.load(std::memory_order_acquire);
+			if (tryPop(value)) {
+				return;
+			}
+			pushed.wait(seen, std::memory_order_acquire);
+		}
+	}
+
+	// العمق التقريبي للطابور
+	size_t size() const {
+		size_t tail = enqueuePos.load(std::memory_order_relaxed);
+		size_t head = dequeuePos.load(std::memory_order_relaxed);
+		return tail > head ? tail - head : 0;
+	}
+
+	size_t capacity() const { return mask + 1; }
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence{ 0 };
+		T value{};
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask = 0;
+	alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+	alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+	// عدادات للإيقاظ عند الإضافة والسحب
+	alignas(64) std::atomic<uint32_t> pushed{ 0 };
+	alignas(64) std::atomic<uint32_t> popped{ 0 };
+};
+
+// رسالة واردة بعد تقطيعها وتحليلها في خيط القراءة
+struct InboundMessage {
+	json content;
+	std::chrono::steady_clock::time_point receivedAt{};
+	bool endOfStream = false;  // علامة نهاية الإدخال
+};
+
+using MessageQueue = BoundedQueue<InboundMessage>;
@@ -0,0 +1,199 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// حالة استخراج رسالة من المخزن المؤقت
+enum class FrameStatus {
+	MESSAGE = 0,      // رسالة كاملة جاهزة
+	NEED_MORE,        // البيانات غير كافية بعد
+	MISSING_LENGTH,   // رؤوس بدون Content-Length
+	INVALID_LENGTH,   // قيمة Content-Length غير صالحة
+	EMPTY_MESSAGE,    // Content-Length: 0
+	TOO_LARGE,        // الرسالة أكبر من الحد المسموح
+	LARGE_MESSAGE     // رسالة كبيرة تُقرأ على كتل خارج المخزن
+};
+
+// حالة القراءة من مصدر الإدخال
+enum class ReadStatus {
+	MESSAGE = 0,
+	END_OF_STREAM,
+	READ_FAILED,
+	INTERRUPTED     // أوقفت القراءة عبر interrupt()
+};
+
+// مجمّع كتل ثابتة الحجم لقراءة محتوى الرسائل الكبيرة دون تخصيص متصل ضخم
+class ChunkPool {
+public:
+	static constexpr size_t CHUNK_SIZE = 64 * 1024;
+	static constexpr size_t MAX_POOLED_CHUNKS = 256;
+
+	std::unique_ptr<char[]> acquire();
+	void release(std::unique_ptr<char[]> chunk);
+
+private:
+	std::mutex mutex;
+	std::vector<std::unique_ptr<char[]>> chunks;
+};
+
+// محتوى رسالة كبيرة موزع على كتل من المجمّع؛ تعود الكتل إليه عند الإتلاف
+class ChunkedBody {
+public:
+	// مكرر أمامي على البايتات عبر حدود الكتل (يُمرر إلى json::parse)
+	class Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = char;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const char*;
+		using reference = const char&;
+
+		Iterator() = default;
+		Iterator(const ChunkedBody* body, size_t position) : body(body), position(position) {}
+
+		reference operator*() const {
+			return body->chunks[position / ChunkPool::CHUNK_SIZE][position % ChunkPool::CHUNK_SIZE];
+		}
+		Iterator& operator++() { ++position; return *this; }
+		Iterator operator++(int) { Iterator copy = *this; ++position; return copy; }
+		bool operator==(const Iterator& other) const { return position == other.position; }
+		bool operator!=(const Iterator& other) const { return position != other.position; }
+
+	private:
+		const ChunkedBody* body = nullptr;
+		size_t position = 0;
+	};
+
+	ChunkedBody() = default;
+	ChunkedBody(ChunkedBody&& other) noexcept;
+	ChunkedBody& operator=(ChunkedBody&& other) noexcept;
+	~ChunkedBody();
+
+	// تجهيز مساحة للكتابة عبر writableData/commit حتى يكتمل الحجم المطلوب
+	void reset(ChunkPool* pool, size_t expectedSize);
+	char* writableData();
+	size_t writableSize() const;
+	void commit(size_t count);
+	bool complete() const { return received == expected; }
+
+	size_t size() const { return received; }
+	Iterator begin() const { return Iterator(this, 0); }
+	Iterator end() const { return Iterator(this, received); }
+	// أول count بايت كنص (للتشخيص)
+	std::string_view preview(size_t count) const;
+	// المحتوى كمقاطع متصلة، مقطع لكل كتلة (للكتابة دون نسخ)
+	size_t segmentCount() const { return chunks.size(); }
+	std::string_view segment(size_t index) const;
+
+private:
+	ChunkPool* pool = nullptr;
+	std::vector<std::unique_ptr<char[]>> chunks;
+	size_t expected = 0;
+	size_t received = 0;
+
+	void releaseChunks();
+};
+
+// محتوى رسالة مستخرجة: متصل في مخزن القارئ أو مقسم على كتل للرسائل الكبيرة
+struct MessageBody {
+	std::string_view data;
+	ChunkedBody chunks;
+	bool chunked = false;
+
+	size_t size() const { return chunked ? chunks.size() : data.size(); }
+	std::string_view preview(size_t count) const {
+		return chunked ? chunks.preview(count) : data.substr(0, count);
+	}
+};
+
+// مُقطِّع الرسائل - يحلل رؤوس LSP داخل مخزن مؤقت واحد يُعاد استخدامه
+// ويعيد محتوى الرسالة كمقطع (span) دون نسخ
+class MessageFramer {
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+	// الحد الافتراضي لحجم الرسالة (قابل للتعديل عبر setMaxMessageSize)
+	static constexpr size_t DEFAULT_MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+	// الرسائل الأكبر من هذا تُقرأ على كتل بدل تكبير المخزن المتصل
+	static constexpr size_t CONTIGUOUS_LIMIT = 1024 * 1024;
+
+	explicit MessageFramer(size_t initialCapacity = DEFAULT_CAPACITY);
+
+	// منطقة قابلة للكتابة بحجم minSize على الأقل لاستقبال بيانات جديدة
+	char* writableData(size_t minSize);
+	size_t writableSize() const;
+	// تأكيد عدد البايتات التي كُتبت في المنطقة القابلة للكتابة
+	void commit(size_t count);
+
+	// استخراج الرسالة التالية؛ المقطع صالح حتى الاستدعاء التالي لأي دالة غير ثابتة
+	// عند LARGE_MESSAGE يجب سحب lastLength() بايت عبر take() قبل الاستدعاء التالي
+	FrameStatus next(std::string_view& body);
+	// نسخ ما يصل إلى maxCount بايت من البيانات المخزنة واستهلاكها
+	size_t take(char* destination, size_t maxCount);
+
+	void setMaxMessageSize(size_t size) { maxMessageSize = size; }
+	size_t getMaxMessageSize() const { return maxMessageSize; }
+
+	// آخر قيمة Content-Length تمت قراءتها (للتسجيل)
+	size_t lastLength() const { return declaredLength; }
+	size_t bufferedSize() const { return end - begin; }
+
+private:
+	std::vector<char> buffer;
+	size_t begin = 0;           // بداية البيانات غير المستهلكة
+	size_t end = 0;             // نهاية البيانات المستلمة
+	size_t declaredLength = 0;
+	size_t pendingSkip = 0;     // بايتات محتوى رسالة مرفوضة يجب تجاهلها
+	size_t maxMessageSize = DEFAULT_MAX_MESSAGE_SIZE;
+
+	// البحث عن نهاية الرؤوس؛ يعيد موضع بداية المحتوى أو 0 إن لم تكتمل
+	size_t findHeaderEnd() const;
+	// تحليل قيمة Content-Length من الرؤوس في مكانها
+	FrameStatus parseHeaders(size_t headerEnd, size_t& length) const;
+	void compact();
+};
+
+// تسجيل سبب تجاهل إطار غير صالح؛ يعيد false إذا لم تكن الحالة خطأ إطار
+bool reportFrameError(FrameStatus status, const MessageFramer& framer);
+
+// قارئ الرسائل - ينفّذ قراءات كبيرة من واصف ملف ويغذي المُقطِّع بها
+class MessageReader {
+public:
+	explicit MessageReader(int fd, size_t initialCapacity = MessageFramer::DEFAULT_CAPACITY);
+	~MessageReader();
+
+	MessageReader(const MessageReader&) = delete;
+	MessageReader& operator=(const MessageReader&) = delete;
+
+	// قراءة الرسالة التالية؛ المقطع المتصل صالح حتى الاستدعاء التالي
+	ReadStatus read(MessageBody& body);
+
+	void setMaxMessageSize(size_t size) { framer.setMaxMessageSize(size); }
+
+	// إيقاظ خيط القراءة المنتظر وإنهاء القراءة (آمن من خيط آخر)
+	void interrupt();
+
+	// عدد استدعاءات read(2) المنفذة (للقياس)
+	size_t syscallCount() const { return syscalls; }
+
+private:
+	int fd;
+	size_t syscalls = 0;
+	MessageFramer framer;
+	ChunkPool chunkPool;
+	std::atomic<bool> interrupted{ false };
+#if !defined(_WIN32)
+	int wakeFds[2] = { -1, -1 };  // أنبوب لإيقاظ poll عند الإيقاف
+#endif
+
+	// قراءة دفعة جديدة من البيانات؛ يعيد عدد البايتات أو 0 عند النهاية و-1 عند الخطأ
+	// و-2 عند الإيقاف
+	long fill();
+	// قراءة مباشرة من الواصف إلى مخزن خارجي بنفس دلالات fill
+	long readInto(char* data, size_t capacity);
+	// قراءة محتوى رسالة كبيرة على كتل
+	ReadStatus readChunked(ChunkedBody& body, size_t length);
+};
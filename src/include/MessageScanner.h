@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+// الحقول العليا لرسالة JSON-RPC كما وجدها المسح السريع
+struct MessageHeader {
+	bool hasMethod = false;
+	bool hasId = false;
+	std::string_view method;   // دون علامات التنصيص
+	std::string_view id;       // نص القيمة كما هو (عدد أو نص بعلامات التنصيص)
+};
+
+// مسح سريع لرسالة JSON-RPC (المرحلة الأولى من التحليل): يستخرج method وid من
+// الكائن الأعلى دون بناء شجرة JSON، ويتخطى بقية القيم (params) بالبحث عن نهايتها
+// فقط دون فك ترميزها. لا يتحقق من صحة القيم المتخطاة؛ الرسائل التي تُعالج
+// تُحلل كاملة بعده
+class MessageScanner {
+public:
+	// يعيد false إذا لم تكن الرسالة كائناً بصيغة متوقعة (دفعة، JSON غير صالح،
+	// أو method بترميز هروب)؛ على المستدعي حينها التحليل الكامل
+	static bool scan(std::string_view body, MessageHeader& header);
+
+private:
+	explicit MessageScanner(std::string_view text) : text(text) {}
+
+	std::string_view text;
+	size_t pos = 0;
+
+	void skipWhitespace();
+	// قراءة نص دون هروب؛ يعيد false إن احتوى على '\' أو لم ينته
+	bool readPlainString(std::string_view& value);
+	bool skipString();
+	bool skipValue();
+	bool skipContainer();
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "SessionRecorder.h"
+#include "Json.h"
+#include "JsonStream.h"
+
+// كاتب الرسائل - يسلسل الردود مباشرة في مخازن من مجمّع قابل لإعادة الاستخدام
+// ويكتبها من خيط مستقل، مع دمج الرسائل المتراكمة في استدعاء writev واحد
+class MessageWriter {
+public:
+	explicit MessageWriter(int fd);
+	~MessageWriter();
+
+	MessageWriter(const MessageWriter&) = delete;
+	MessageWriter& operator=(const MessageWriter&) = delete;
+
+	// تشغيل خيط الكتابة
+	void start();
+	// إيقاف خيط الكتابة بعد كتابة كل الرسائل المعلقة
+	void stop();
+	// مثل stop لكن بمهلة محددة؛ يعيد false إذا لم تكتمل الكتابة خلالها
+	bool stop(std::chrono::milliseconds timeout);
+
+	// تسلسل رسالة وإضافتها إلى طابور الكتابة
+	void send(const json& message);
+	// رسالة تُكتب تدفقياً في مخزن من المجمّع بعد مساحة الرأس، دون بناء شجرة json
+	JsonStream beginMessage();
+	// إرسال رسالة من beginMessage؛ طولها يُكتب في المساحة المحجوزة أمامها
+	void send(JsonStream&& message);
+
+	// هل فشلت الكتابة (مثلاً انقطاع الأنبوب)
+	bool failed() const;
+	// دالة تُستدعى مرة واحدة من خيط الكتابة عند أول فشل
+	void onFailure(std::function<void()> handler);
+	// تسجيل كل رسالة مرسلة (يُضبط قبل start)
+	void setRecorder(SessionRecorder* sessionRecorder) { recorder = sessionRecorder; }
+
+private:
+	// مساحة محجوزة في بداية كل مخزن لرأس Content-Length
+	static constexpr size_t HEADER_RESERVE = 32;
+	// أقصى عدد من المخازن المحفوظة في المجمّع
+	static constexpr size_t MAX_POOLED_BUFFERS = 64;
+	// المخازن الأكبر من هذا لا تُعاد إلى المجمّع
+	static constexpr size_t MAX_POOLED_CAPACITY = 1024 * 1024;
+
+	// رسالة جاهزة للكتابة: الرأس يبدأ عند offset داخل المخزن
+	struct Frame {
+		std::string buffer;
+		size_t offset = 0;
+	};
+
+	int fd;
+	std::thread thread;
+	mutable std::mutex mutex;
+	std::condition_variable ready;
+	std::condition_variable finished;
+	std::vector<Frame> pending;
+	std::vector<std::string> pool;
+	bool stopping = false;
+	bool running = false;
+	bool loopExited = false;
+	bool writeFailed = false;
+	std::function<void()> failureHandler;
+	SessionRecorder* recorder = nullptr;
+
+	std::string acquireBuffer();
+	// كتابة الرأس أمام المحتوى المسلسل بعد HEADER_RESERVE وإضافة الرسالة إلى الطابور
+	void enqueue(Frame frame);
+	void writerLoop();
+	// كتابة دفعة من الرسائل؛ تعيد false عند الفشل مع errno الاستدعاء الفاشل في error
+	bool writeBatch(std::vector<Frame>& batch, int& error);
+};
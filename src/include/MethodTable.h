@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace detail {
+	// يُستدعى فقط إن لم توجد بذرة بلا تصادم (مثلاً طريقة مسجلة مرتين)، فيفشل
+	// تقييم الجدول عند الترجمة برسالة تحمل هذا الاسم
+	inline void methodTableHasNoPerfectHash() {}
+}
+
+// جدول طرق ثابت بتجزئة مثالية تُحسب عند الترجمة: يُبحث عن بذرة للتجزئة
+// تضع كل اسم في خانة خاصة به، فالبحث تجزئة واحدة ومقارنة نص واحدة مهما زاد
+// عدد الطرق. Entry يحمل اسم طريقته في الحقل method
+template <typename Entry, size_t Count>
+class MethodTable {
+public:
+	// ضعف عدد الطرق على الأقل (قوة للعدد 2) لتوجد البذرة بسرعة
+	static constexpr size_t SLOTS = [] {
+		size_t slots = 8;
+		while (slots < Count * 2) {
+			slots *= 2;
+		}
+		return slots;
+	}();
+
+	consteval explicit MethodTable(const std::array<Entry, Count>& entries) : entries(entries) {
+		for (seed = 0; !place(); ++seed) {
+			if (seed == MAX_SEED) {
+				detail::methodTableHasNoPerfectHash();
+			}
+		}
+	}
+
+	constexpr const Entry* find(std::string_view method) const {
+		uint8_t index = slots[hash(method, seed) & (SLOTS - 1)];
+		if (index == EMPTY || entries[index].method != method) {
+			return nullptr;
+		}
+		return &entries[index];
+	}
+
+	// ثمانية بايتات في كل ضربة: أسماء الطرق طويلة (textDocument/...) فالتجزئة
+	// بايتاً بايتاً أبطأ من مقارنتها خطياً بجدول صغير
+	static constexpr uint64_t hash(std::string_view text, uint64_t seed) {
+		size_t size = text.size();
+		uint64_t value = seed ^ (size * 0x9E3779B97F4A7C15ull);
+		if (size < 8) {
+			return mix(value ^ loadShort(text));
+		}
+		for (size_t i = 0; i + 8 < size; i += 8) {
+			value = mix(value ^ load(text.data() + i));
+		}
+		// الذيل: آخر ثمانية بايتات وإن تداخلت مع ما قبلها
+		return mix(value ^ load(text.data() + size - 8));
+	}
+
+private:
+	static constexpr uint8_t EMPTY = 0xFF;
+	static constexpr uint64_t MAX_SEED = 1u << 16;
+	static_assert(Count < EMPTY, "too many methods for the slot index type");
+
+	std::array<Entry, Count> entries;
+	std::array<uint8_t, SLOTS> slots{};
+	uint64_t seed = 0;
+
+	static constexpr uint64_t mix(uint64_t value) {
+		value *= 0xBF58476D1CE4E5B9ull;
+		return value ^ (value >> 31);
+	}
+
+	static constexpr uint64_t load(const char* bytes) {
+		// قراءة واحدة وقت التشغيل؛ الترتيب يطابق الحساب البايتي عند الترجمة
+		if (std::endian::native == std::endian::little && !std::is_constant_evaluated()) {
+			uint64_t word;
+			std::memcpy(&word, bytes, sizeof(word));
+			return word;
+		}
+		uint64_t word = 0;
+		for (size_t k = 0; k < 8; ++k) {
+			word |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[k])) << (8 * k);
+		}
+		return word;
+	}
+
+	static constexpr uint64_t loadShort(std::string_view text) {
+		uint64_t word = 0;
+		for (size_t k = 0; k < text.size(); ++k) {
+			word |= static_cast<uint64_t>(static_cast<unsigned char>(text[k])) << (8 * k);
+		}
+		return word;
+	}
+
+	// توزيع الطرق بالبذرة الحالية؛ يعيد false عند أول تصادم
+	constexpr bool place() {
+		slots.fill(EMPTY);
+		for (size_t i = 0; i < Count; ++i) {
+			uint8_t& slot = slots[hash(entries[i].method, seed) & (SLOTS - 1)];
+			if (slot != EMPTY) {
+				return false;
+			}
+			slot = static_cast<uint8_t>(i);
+		}
+		return true;
+	}
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include "Json.h"
+
+// مقياس رقمي واحد (عداد أو قيمة لحظية) آمن للاستخدام من عدة خيوط
+class Metric {
+public:
+	void add(int64_t delta = 1) { value.fetch_add(delta, std::memory_order_relaxed); }
+	void set(int64_t newValue) { value.store(newValue, std::memory_order_relaxed); }
+	// تحديث القيمة القصوى المسجلة
+	void updateMax(int64_t candidate) {
+		int64_t current = value.load(std::memory_order_relaxed);
+		while (candidate > current &&
+			!value.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+		}
+	}
+	int64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<int64_t> value{ 0 };
+};
+
+// سجل المقاييس - يُحصل على المقياس مرة واحدة بالاسم ثم يُحدَّث دون أقفال
+class Metrics {
+public:
+	// الحصول على مقياس بالاسم (يُنشأ عند أول طلب ويبقى عنوانه ثابتاً)
+	static Metric& get(const std::string& name);
+
+	// لقطة لجميع المقاييس الحالية
+	static json snapshot();
+
+private:
+	static std::mutex mutex;
+	static std::map<std::string, Metric> metrics;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include "Json.h"
+#include "JsonStream.h"
+#include "MessageWriter.h"
+
+// بث نتيجة طلب على دفعات عبر $/progress عندما يرسل المحرر partialResultToken.
+// العناصر تُكتب مباشرة في مخزن رسالة الدفعة الجارية دون بناء شجرة json لها.
+// الدفعة تُرسل عند امتلائها، والدفعة الأولى تُرسل أيضاً حالما تنقضي مهلة
+// الاستجابة الأولى ولو لم تمتلئ، فيبدأ المحرر العرض قبل اكتمال النتيجة.
+// المهلة تُفحص عند كل إضافة وعند كل poll من حلقة المنتج بين خطواتها.
+// بعد finish يجب أن يكون رد الطلب نفسه فارغاً (مصفوفة فارغة) حسب مواصفة LSP
+class PartialResultStream {
+public:
+	// مهلة وصول أول دفعة منذ بدء معالجة الطلب
+	static constexpr std::chrono::milliseconds FIRST_CHUNK_BUDGET{ 50 };
+	// عدد العناصر في كل دفعة
+	static constexpr size_t CHUNK_SIZE = 256;
+
+	PartialResultStream(json token, MessageWriter& writer,
+		std::chrono::milliseconds firstChunkBudget = FIRST_CHUNK_BUDGET, size_t chunkSize = CHUNK_SIZE);
+
+	// إضافة عنصر يكتبه writeItem(JsonStream&) كقيمة واحدة في مصفوفة الدفعة
+	template <typename WriteItem>
+	void add(WriteItem&& writeItem) {
+		if (pending == 0) {
+			beginChunk();
+		}
+		writeItem(chunk);
+		++pending;
+		itemAdded();
+	}
+	// نقطة فحص من حلقة المنتج: إرسال ما تجمع إن انقضت مهلة الدفعة الأولى،
+	// فلا تنتظر العناصر المضافة عنصراً تالياً قد يتأخر
+	void poll();
+	// إرسال العناصر المتبقية
+	void finish();
+
+	size_t chunksSent() const { return chunks; }
+
+private:
+	json token;
+	MessageWriter& writer;
+	std::chrono::steady_clock::time_point start;
+	std::chrono::milliseconds firstChunkBudget;
+	size_t chunkSize;
+	// رسالة الدفعة الجارية، مفتوحة عند مصفوفة value
+	JsonStream chunk;
+	size_t pending = 0;
+	size_t chunks = 0;
+
+	void beginChunk();
+	void itemAdded();
+	void flush();
+};
@@ -0,0 +1,500 @@
+// ملف مولد من src/protocol/metaModel.json بواسطة src/tools/ProtocolGen.cpp (make protocol)؛ لا يُعدل يدوياً
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Json.h"
+#include "JsonStream.h"
+
+// أنواع LSP 3.17.0 للرسائل التي يعالجها الخادم.
+// decode يمر على أعضاء كل كائن مرة واحدة وينقل النصوص منه (فيبقى المصدر بنصوص فارغة)؛
+// الأعضاء غير المعروفة تُتجاهل، ويعيد false لعضو إلزامي مفقود أو قيمة من نوع خاطئ.
+// encode يكتب الخصائص بترتيب أسمائها كتسلسل json ويحذف الاختيارية الغائبة
+namespace lsp {
+
+// Defines how the host (editor) should sync document changes to the language server.
+enum class TextDocumentSyncKind : uint32_t {
+	None = 0,
+	Full = 1,
+	Incremental = 2
+};
+
+// How a completion was triggered
+enum class CompletionTriggerKind : uint32_t {
+	Invoked = 1,
+	TriggerCharacter = 2,
+	TriggerForIncompleteCompletions = 3
+};
+
+// The kind of a completion entry.
+enum class CompletionItemKind : uint32_t {
+	Text = 1,
+	Method = 2,
+	Function = 3,
+	Constructor = 4,
+	Field = 5,
+	Variable = 6,
+	Class = 7,
+	Interface = 8,
+	Module = 9,
+	Property = 10,
+	Unit = 11,
+	Value = 12,
+	Enum = 13,
+	Keyword = 14,
+	Snippet = 15,
+	Color = 16,
+	File = 17,
+	Reference = 18,
+	Folder = 19,
+	EnumMember = 20,
+	Constant = 21,
+	Struct = 22,
+	Event = 23,
+	Operator = 24,
+	TypeParameter = 25
+};
+
+// A set of predefined position encoding kinds.
+namespace PositionEncodingKind {
+	inline constexpr std::string_view UTF8 = "utf-8";
+	inline constexpr std::string_view UTF16 = "utf-16";
+	inline constexpr std::string_view UTF32 = "utf-32";
+}
+
+// Describes the content type that a client supports in various result literals like `Hover`, `ParameterInfo` or `CompletionItem`.
+namespace MarkupKind {
+	inline constexpr std::string_view PlainText = "plaintext";
+	inline constexpr std::string_view Markdown = "markdown";
+}
+
+namespace TraceValues {
+	inline constexpr std::string_view Off = "off";
+	inline constexpr std::string_view Messages = "messages";
+	inline constexpr std::string_view Verbose = "verbose";
+}
+
+// Position in a text document expressed as zero-based line and character offset.
+struct Position {
+	// Line position in a document (zero-based).
+	uint32_t line{};
+	// Character offset on a line in a document (zero-based).
+	uint32_t character{};
+};
+
+// A range in a text document expressed as (zero-based) start and end positions.
+struct Range {
+	// The range's start position.
+	Position start{};
+	// The range's end position.
+	Position end{};
+};
+
+// A literal to identify a text document in the client.
+struct TextDocumentIdentifier {
+	// The text document's uri.
+	std::string uri{};
+};
+
+// A text document identifier to denote a specific version of a text document.
+struct VersionedTextDocumentIdentifier {
+	// The text document's uri.
+	std::string uri{};
+	// The version number of this document.
+	int32_t version{};
+};
+
+// An item to transfer a text document from the client to the server.
+struct TextDocumentItem {
+	// The text document's uri.
+	std::string uri{};
+	// The text document's language identifier.
+	std::string languageId{};
+	// The version number of this document (it will increase after each change, including undo/redo).
+	int32_t version{};
+	// The content of the opened text document.
+	std::string text{};
+};
+
+// A parameter literal used in requests to pass a text document and a position inside that document.
+struct TextDocumentPositionParams {
+	// The text document.
+	TextDocumentIdentifier textDocument{};
+	// The position inside the text document.
+	Position position{};
+};
+
+struct WorkDoneProgressParams {
+	// An optional token that a server can use to report work done progress.
+	std::optional<json> workDoneToken{};
+};
+
+struct PartialResultParams {
+	// An optional token that a server can use to report partial results (e.g. streaming) to the client.
+	std::optional<json> partialResultToken{};
+};
+
+struct CancelParams {
+	// The request id to cancel.
+	json id{};
+};
+
+// The parameters sent in an open text document notification
+struct DidOpenTextDocumentParams {
+	// The document that was opened.
+	TextDocumentItem textDocument{};
+};
+
+struct TextDocumentContentChangeEvent {
+	// The range of the document that changed.
+	std::optional<Range> range{};
+	// The optional length of the range that got replaced.
+	std::optional<uint32_t> rangeLength{};
+	// The new text for the provided range.
+	std::string text{};
+};
+
+// The change text document notification's parameters.
+struct DidChangeTextDocumentParams {
+	// The document that did change.
+	VersionedTextDocumentIdentifier textDocument{};
+	// The actual content changes.
+	std::vector<TextDocumentContentChangeEvent> contentChanges{};
+};
+
+// The parameters sent in a close text document notification
+struct DidCloseTextDocumentParams {
+	// The document that was closed.
+	TextDocumentIdentifier textDocument{};
+};
+
+// Contains additional information about the context in which a completion request is triggered.
+struct CompletionContext {
+	// How the completion was triggered.
+	CompletionTriggerKind triggerKind{};
+	// The trigger character (a single character) that has trigger code complete.
+	std::optional<std::string> triggerCharacter{};
+};
+
+// Completion parameters
+struct CompletionParams {
+	// The text document.
+	TextDocumentIdentifier textDocument{};
+	// The position inside the text document.
+	Position position{};
+	// An optional token that a server can use to report work done progress.
+	std::optional<json> workDoneToken{};
+	// An optional token that a server can use to report partial results (e.g. streaming) to the client.
+	std::optional<json> partialResultToken{};
+	// The completion context.
+	std::optional<CompletionContext> context{};
+};
+
+// A completion item represents a text snippet that is proposed to complete text that is being typed.
+struct CompletionItem {
+	// The label of this completion item.
+	std::string label{};
+	// The kind of this completion item.
+	std::optional<CompletionItemKind> kind{};
+	// A human-readable string with additional information about this item, like type or symbol information.
+	std::optional<std::string> detail{};
+	// A human-readable string that represents a doc-comment.
+	std::optional<json> documentation{};
+};
+
+// Represents a collection of {@link CompletionItem completion items} to be presented in the editor.
+struct CompletionList {
+	// This list it not complete.
+	bool isIncomplete{};
+	// The completion items.
+	std::vector<CompletionItem> items{};
+};
+
+// A `MarkupContent` literal represents a string value which content is interpreted base on its kind flag.
+struct MarkupContent {
+	// The type of the Markup
+	std::string kind{};
+	// The content itself
+	std::string value{};
+};
+
+// A workspace folder inside a client.
+struct WorkspaceFolder {
+	// The associated URI for this workspace folder.
+	std::string uri{};
+	// The name of the workspace folder.
+	std::string name{};
+};
+
+struct WorkspaceFoldersInitializeParams {
+	// The workspace folders configured in the client when the server starts.
+	std::optional<std::vector<WorkspaceFolder>> workspaceFolders{};
+};
+
+struct InitializeParamsClientInfo {
+	// The name of the client as defined by the client.
+	std::string name{};
+	// The client's version as defined by the client.
+	std::optional<std::string> version{};
+};
+
+struct TextDocumentSyncClientCapabilities {
+	// Whether text document synchronization supports dynamic registration.
+	std::optional<bool> dynamicRegistration{};
+	// The client supports sending will save notifications.
+	std::optional<bool> willSave{};
+	// The client supports sending a will save request and waits for a response providing text edits which will be applied to the document before it is saved.
+	std::optional<bool> willSaveWaitUntil{};
+	// The client supports did save notifications.
+	std::optional<bool> didSave{};
+};
+
+struct CompletionClientCapabilitiesCompletionItemResolveSupport {
+	// The properties that a client can resolve lazily.
+	std::vector<std::string> properties{};
+};
+
+struct CompletionClientCapabilitiesCompletionItem {
+	// Indicates which properties a client can resolve lazily on a completion item.
+	std::optional<CompletionClientCapabilitiesCompletionItemResolveSupport> resolveSupport{};
+};
+
+// Completion client capabilities
+struct CompletionClientCapabilities {
+	// Whether completion supports dynamic registration.
+	std::optional<bool> dynamicRegistration{};
+	// The client supports to send additional context information for a `textDocument/completion` request.
+	std::optional<bool> contextSupport{};
+	// The client supports the following `CompletionItem` specific capabilities.
+	std::optional<CompletionClientCapabilitiesCompletionItem> completionItem{};
+};
+
+// Text document specific client capabilities.
+struct TextDocumentClientCapabilities {
+	// Defines which synchronization capabilities the client supports.
+	std::optional<TextDocumentSyncClientCapabilities> synchronization{};
+	// Capabilities specific to the `textDocument/completion` request.
+	std::optional<CompletionClientCapabilities> completion{};
+};
+
+// General client capabilities.
+struct GeneralClientCapabilities {
+	// The position encodings supported by the client.
+	std::optional<std::vector<std::string>> positionEncodings{};
+};
+
+// Defines the capabilities provided by the client.
+struct ClientCapabilities {
+	// Text document specific client capabilities.
+	std::optional<TextDocumentClientCapabilities> textDocument{};
+	// General client capabilities.
+	std::optional<GeneralClientCapabilities> general{};
+	// Experimental client capabilities.
+	std::optional<json> experimental{};
+};
+
+struct InitializeParams {
+	// An optional token that a server can use to report work done progress.
+	std::optional<json> workDoneToken{};
+	// The process Id of the parent process that started the server.
+	std::optional<int32_t> processId{};
+	// Information about the client
+	std::optional<InitializeParamsClientInfo> clientInfo{};
+	// The locale the client is currently showing the user interface in.
+	std::optional<std::string> locale{};
+	// The rootPath of the workspace.
+	std::optional<std::string> rootPath{};
+	// The rootUri of the workspace.
+	std::optional<std::string> rootUri{};
+	// The capabilities provided by the client (editor or tool)
+	ClientCapabilities capabilities{};
+	// User provided initialization options.
+	std::optional<json> initializationOptions{};
+	// The initial trace setting.
+	std::optional<std::string> trace{};
+	// The workspace folders configured in the client when the server starts.
+	std::optional<std::vector<WorkspaceFolder>> workspaceFolders{};
+};
+
+struct InitializeResultServerInfo {
+	// The name of the server as defined by the server.
+	std::string name{};
+	// The server's version as defined by the server.
+	std::optional<std::string> version{};
+};
+
+// Completion options.
+struct CompletionOptions {
+	std::optional<bool> workDoneProgress{};
+	// Most tools trigger completion request automatically without explicitly requesting it using a keyboard shortcut (e.g. Ctrl+Space).
+	std::optional<std::vector<std::string>> triggerCharacters{};
+	// The server provides support to resolve additional information for a completion item.
+	std::optional<bool> resolveProvider{};
+};
+
+// Defines the capabilities provided by a language server.
+struct ServerCapabilities {
+	// The position encoding the server picked from the encodings offered by the client via the client capability `general.positionEncodings`.
+	std::optional<std::string> positionEncoding{};
+	// Defines how text documents are synced.
+	std::optional<json> textDocumentSync{};
+	// The server provides completion support.
+	std::optional<CompletionOptions> completionProvider{};
+};
+
+// The result returned from an initialize request.
+struct InitializeResult {
+	// The capabilities the language server provides.
+	ServerCapabilities capabilities{};
+	// Information about the server.
+	std::optional<InitializeResultServerInfo> serverInfo{};
+};
+
+struct TextDocumentSyncOptions {
+	// Open and close notifications are sent to the server.
+	std::optional<bool> openClose{};
+	// Change notifications are sent to the server.
+	std::optional<TextDocumentSyncKind> change{};
+};
+
+struct WorkDoneProgressOptions {
+	std::optional<bool> workDoneProgress{};
+};
+
+bool decode(json& value, Position& out);
+void encode(JsonStream& out, const Position& value);
+bool decode(json& value, Range& out);
+void encode(JsonStream& out, const Range& value);
+bool decode(json& value, TextDocumentIdentifier& out);
+void encode(JsonStream& out, const TextDocumentIdentifier& value);
+bool decode(json& value, VersionedTextDocumentIdentifier& out);
+void encode(JsonStream& out, const VersionedTextDocumentIdentifier& value);
+bool decode(json& value, TextDocumentItem& out);
+void encode(JsonStream& out, const TextDocumentItem& value);
+bool decode(json& value, TextDocumentPositionParams& out);
+void encode(JsonStream& out, const TextDocumentPositionParams& value);
+bool decode(json& value, WorkDoneProgressParams& out);
+void encode(JsonStream& out, const WorkDoneProgressParams& value);
+bool decode(json& value, PartialResultParams& out);
+void encode(JsonStream& out, const PartialResultParams& value);
+bool decode(json& value, CancelParams& out);
+void encode(JsonStream& out, const CancelParams& value);
+bool decode(json& value, DidOpenTextDocumentParams& out);
+void encode(JsonStream& out, const DidOpenTextDocumentParams& value);
+bool decode(json& value, TextDocumentContentChangeEvent& out);
+void encode(JsonStream& out, const TextDocumentContentChangeEvent& value);
+bool decode(json& value, DidChangeTextDocumentParams& out);
+void encode(JsonStream& out, const DidChangeTextDocumentParams& value);
+bool decode(json& value, DidCloseTextDocumentParams& out);
+void encode(JsonStream& out, const DidCloseTextDocumentParams& value);
+bool decode(json& value, CompletionContext& out);
+void encode(JsonStream& out, const CompletionContext& value);
+bool decode(json& value, CompletionParams& out);
+void encode(JsonStream& out, const CompletionParams& value);
+bool decode(json& value, CompletionItem& out);
+void encode(JsonStream& out, const CompletionItem& value);
+bool decode(json& value, CompletionList& out);
+void encode(JsonStream& out, const CompletionList& value);
+bool decode(json& value, MarkupContent& out);
+void encode(JsonStream& out, const MarkupContent& value);
+bool decode(json& value, WorkspaceFolder& out);
+void encode(JsonStream& out, const WorkspaceFolder& value);
+bool decode(json& value, WorkspaceFoldersInitializeParams& out);
+void encode(JsonStream& out, const WorkspaceFoldersInitializeParams& value);
+bool decode(json& value, InitializeParamsClientInfo& out);
+void encode(JsonStream& out, const InitializeParamsClientInfo& value);
+bool decode(json& value, TextDocumentSyncClientCapabilities& out);
+void encode(JsonStream& out, const TextDocumentSyncClientCapabilities& value);
+bool decode(json& value, CompletionClientCapabilitiesCompletionItemResolveSupport& out);
+void encode(JsonStream& out, const CompletionClientCapabilitiesCompletionItemResolveSupport& value);
+bool decode(json& value, CompletionClientCapabilitiesCompletionItem& out);
+void encode(JsonStream& out, const CompletionClientCapabilitiesCompletionItem& value);
+bool decode(json& value, CompletionClientCapabilities& out);
+void encode(JsonStream& out, const CompletionClientCapabilities& value);
+bool decode(json& value, TextDocumentClientCapabilities& out);
+void encode(JsonStream& out, const TextDocumentClientCapabilities& value);
+bool decode(json& value, GeneralClientCapabilities& out);
+void encode(JsonStream& out, const GeneralClientCapabilities& value);
+bool decode(json& value, ClientCapabilities& out);
+void encode(JsonStream& out, const ClientCapabilities& value);
+bool decode(json& value, InitializeParams& out);
+void encode(JsonStream& out, const InitializeParams& value);
+bool decode(json& value, InitializeResultServerInfo& out);
+void encode(JsonStream& out, const InitializeResultServerInfo& value);
+bool decode(json& value, CompletionOptions& out);
+void encode(JsonStream& out, const CompletionOptions& value);
+bool decode(json& value, ServerCapabilities& out);
+void encode(JsonStream& out, const ServerCapabilities& value);
+bool decode(json& value, InitializeResult& out);
+void encode(JsonStream& out, const InitializeResult& value);
+bool decode(json& value, TextDocumentSyncOptions& out);
+void encode(JsonStream& out, const TextDocumentSyncOptions& value);
+bool decode(json& value, WorkDoneProgressOptions& out);
+void encode(JsonStream& out, const WorkDoneProgressOptions& value);
+
+// الطلبات والإشعارات: الطريقة ونوع معاملاتها (void لمن لا معاملات له)
+
+// The initialize request is sent from the client to the server.
+struct InitializeRequest {
+	static constexpr std::string_view METHOD = "initialize";
+	static constexpr bool IS_REQUEST = true;
+	using Params = InitializeParams;
+};
+
+// A shutdown request is sent from the client to the server.
+struct ShutdownRequest {
+	static constexpr std::string_view METHOD = "shutdown";
+	static constexpr bool IS_REQUEST = true;
+	using Params = void;
+};
+
+// Request to request completion at a given text document position.
+struct CompletionRequest {
+	static constexpr std::string_view METHOD = "textDocument/completion";
+	static constexpr bool IS_REQUEST = true;
+	using Params = CompletionParams;
+};
+
+// Request to resolve additional information for a given completion item.The request's parameter is of type {@link CompletionItem} the response is of type {@link CompletionItem} or a Thenable that resolves to such.
+struct CompletionResolveRequest {
+	static constexpr std::string_view METHOD = "completionItem/resolve";
+	static constexpr bool IS_REQUEST = true;
+	using Params = CompletionItem;
+};
+
+// The exit event is sent from the client to the server to ask the server to exit its process.
+struct ExitNotification {
+	static constexpr std::string_view METHOD = "exit";
+	static constexpr bool IS_REQUEST = false;
+	using Params = void;
+};
+
+struct CancelNotification {
+	static constexpr std::string_view METHOD = "$/cancelRequest";
+	static constexpr bool IS_REQUEST = false;
+	using Params = CancelParams;
+};
+
+// The document open notification is sent from the client to the server to signal newly opened text documents.
+struct DidOpenTextDocumentNotification {
+	static constexpr std::string_view METHOD = "textDocument/didOpen";
+	static constexpr bool IS_REQUEST = false;
+	using Params = DidOpenTextDocumentParams;
+};
+
+// The document change notification is sent from the client to the server to signal changes to a text document.
+struct DidChangeTextDocumentNotification {
+	static constexpr std::string_view METHOD = "textDocument/didChange";
+	static constexpr bool IS_REQUEST = false;
+	using Params = DidChangeTextDocumentParams;
+};
+
+// The document close notification is sent from the client to the server when the document got closed in the client.
+struct DidCloseTextDocumentNotification {
+	static constexpr std::string_view METHOD = "textDocument/didClose";
+	static constexpr bool IS_REQUEST = false;
+	using Params = DidCloseTextDocumentParams;
+};
+}
@@ -1,19 +1,235 @@
 #pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
-#include "json.hpp"
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Json.h"
+#include "JsonStream.h"
+#include "AsyncTask.h"
 #include "Logger.h"
+#include "Cancellation.h"
+#include "DocManager.h"
+#include "MessageQueue.h"
+#include "MessageReader.h"
+#include "MessageWriter.h"
+#include "Protocol.h"
+#include "SessionRecorder.h"
+#include "ThreadPool.h"
+#include "WorkspaceIndex.h"
 
-using json = nlohmann::json;
+// حالات دورة حياة الخادم وفق بروتوكول LSP
+enum class ServerState {
+	UNINITIALIZED = 0,  // قبل طلب initialize
+	RUNNING,            // بعد التهيئة
+	SHUTTING_DOWN       // بعد طلب shutdown وبانتظار exit
+};
+
+// أين ومتى يُنفذ معالج الطريقة
+enum class MethodExecution {
+	ON_RECEIPT,  // على خيط القراءة عند الاستلام قبل الطابور ($/cancelRequest)
+	IMMEDIATE,   // على خيط المعالجة بالترتيب (دورة الحياة)
+	POOLED       // على مجمّع الخيوط، وعلى سلسلة المستند إن خص مستنداً
+};
 
+// ما اتُفق عليه مع العميل في initialize؛ تختار منه الأنظمة الفرعية مسارها الأسرع
+struct NegotiatedCapabilities {
+	// UTF-8 إن عرضه العميل: أعمدة المواضع إزاحات بالبايت فلا تحويل عبر النص العربي
+	PositionEncoding positionEncoding = PositionEncoding::UTF16;
+	// didChange بتعديلات ضمن نطاقات بدل النص كاملاً
+	lsp::TextDocumentSyncKind textDocumentSync = lsp::TextDocumentSyncKind::Incremental;
+	// العميل يكمل detail وdocumentation بـ completionItem/resolve، فتُرسل القائمة مختصرة
+	bool completionResolve = false;
+};
+
+// إعدادات تشغيل الخادم من سطر الأوامر
+struct ServerOptions {
+	// الحد الأقصى لحجم الرسالة الواحدة؛ الرسائل الأكبر تُتجاهل بأمان
+	size_t maxMessageSize = MessageFramer::DEFAULT_MAX_MESSAGE_SIZE;
+	// عدد خيوط العمل (0 = حسب عدد الأنوية)
+	size_t workerThreads = 0;
+	// عنوان الاستماع (unix:<path> أو tcp:<port>)؛ فارغ يعني stdin/stdout
+	std::string listenAddress;
+	// ملف تسجيل الجلسة لإعادة تشغيلها (stdin/stdout فقط)؛ فارغ يعني بلا تسجيل
+	std::string recordFile;
+	// فهرسة مجلد الجذر عند initialize؛ تُفعّل دائماً مع --listen
+	bool indexWorkspace = false;
+};
+
+// جلسة LSP واحدة: على stdin/stdout بمجمّع خيوط خاص، أو على اتصال مقبس
+// يشارك مجمّع خيوط خادم الاستماع. لكل جلسة مستنداتها وطلباتها وكاتبها
 class LSPServer {
 public:
+	explicit LSPServer(const ServerOptions& options = {});
+	LSPServer(const ServerOptions& options, ThreadPool& sharedPool, int fd);
+
+	// حلقة stdin/stdout الكاملة حتى exit أو نهاية الإدخال
 	int run();
-	void handleMessage(const json& msg);
+	void handleMessage(json msg);
+
+	// واجهة الجلسات التي تقودها حلقة أحداث خارجية
+	void start();
+	// تحليل محتوى رسالة مقطّعة والتحقق منها؛ يعيد false إذا رُفضت
+	bool parseMessage(const MessageBody& body, json& content);
+	// تسليم رسالة محللة (يعالج $/cancelRequest فوراً)
+	void deliver(json msg);
+	// استلمت الجلسة exit أو انقطع إخراجها
+	bool finished() const;
+	// انتظار انتهاء مهام الجلسة على مجمّع الخيوط
+	bool waitForTasks(std::chrono::milliseconds timeout);
+	void cancelPending() { pendingRequests.cancelAll(); }
+	// إنهاء الكتابة المعلقة خلال المهلة
+	bool stopOutput(std::chrono::milliseconds timeout) { return writer.stop(timeout); }
 
 private:
-	void sendResponse(const json& response);
+	// سعة طابور الرسائل بين خيط القراءة والمعالج
+	static constexpr size_t QUEUE_CAPACITY = 1024;
+	// المهلة القصوى لإنهاء الكتابة المعلقة عند الخروج
+	static constexpr std::chrono::milliseconds DRAIN_TIMEOUT{ 2000 };
+
+	ServerOptions options;
+
+	// مجمّع خيوط العمل (خاص بالجلسة أو مشترك) وسلاسل التنفيذ لكل مستند
+	std::unique_ptr<ThreadPool> ownedPool;
+	ThreadPool& pool;
+	std::mutex strandsMutex;
+	std::unordered_map<std::string, std::shared_ptr<Strand>> strands;
+
+	// دفعة didChange متتالية لمستند واحد تُطبق بمهمة واحدة؛ تقبل الإضافة
+	// ما دامت لم تبدأ ولم تصل بعدها رسالة أخرى لنفس المستند
+	struct ChangeBatch {
+		std::mutex mutex;
+		bool started = false;
+		std::vector<std::shared_ptr<json>> messages;
+
+		bool tryAppend(const std::shared_ptr<json>& message);
+	};
+	// الدفعة المفتوحة في ذيل سلسلة كل مستند (محمية بـ strandsMutex)
+	std::unordered_map<std::string, std::shared_ptr<ChangeBatch>> openBatches;
+
+	// مستندات الجلسة المفتوحة: طبقة خاصة بالعميل فوق فهرس مساحة العمل المشترك
+	DocumentManager docManager;
+	std::shared_ptr<WorkspaceIndex> workspace;
+
+	// تسجيل الرسائل الواردة والصادرة (--record)؛ يسبق الكاتب ليبقى بعد إيقافه
+	std::unique_ptr<SessionRecorder> recorder;
+	// قارئ الرسائل على stdin بقراءات كبيرة ومخزن واحد (غير موجود لجلسات المقابس)
+	std::unique_ptr<MessageReader> input;
+	// كاتب الرسائل على stdout أو على المقبس
+	MessageWriter writer;
+
+	// الطلبات المستلمة التي لم يُرسل ردها بعد
+	RequestTable pendingRequests;
+
+	// أحدث طلب إكمال لكل مستند؛ الطلب الأقدم يُجاب فوراً بنتيجة فارغة
+	std::mutex completionsMutex;
+	std::unordered_map<std::string, json> latestCompletions;
+
+	// ردود دفعة JSON-RPC تُجمع وتُرسل معاً كمصفوفة واحدة عند اكتمالها
+	struct BatchResponse {
+		std::mutex mutex;
+		// كل رد مسلسل مرة واحدة؛ المصفوفة تُنسخ منها عند الإرسال
+		std::vector<std::string> responses;
+		size_t remaining = 0;
+	};
+	// الطلبات المنتمية إلى دفعة، مفهرسة بمعرفها
+	std::mutex batchesMutex;
+	std::unordered_map<std::string, std::shared_ptr<BatchResponse>> batchedRequests;
+
+	// عدد مهام الجلسة المرسلة إلى المجمّع ولم تنتهِ
+	std::mutex tasksMutex;
+	std::condition_variable tasksIdle;
+	size_t activeTasks = 0;
+
+	ServerState state = ServerState::UNINITIALIZED;
+	bool exitRequested = false;
+	// يُضبط في initialize قبل أي رسالة أخرى ثم يُقرأ فقط
+	NegotiatedCapabilities negotiated;
+
+	// طريقة مسجلة في جدول المعالجات (findMethod)
+	struct MethodEntry {
+		std::string_view method;
+		bool isRequest;
+		TaskPriority priority;
+		MethodExecution execution;
+		// فك المعاملات بنوعها المولد ثم استدعاء المعالج
+		AsyncTask<void> (*invoke)(LSPServer& server, json& msg, CancellationToken token);
+	};
+	// البحث في الجدول بتجزئة مثالية محسوبة عند الترجمة؛ nullptr لطريقة لا نعالجها
+	static const MethodEntry* findMethod(std::string_view method);
+	// سطر تسجيل طريقة: Message من أنواع Protocol.h (METHOD وIS_REQUEST وParams)،
+	// وHandler يستقبل المعاملات المفكوكة ثم (للطلبات) المعرف ورمز الإلغاء
+	template <typename Message, auto Handler>
+	static constexpr MethodEntry handler(TaskPriority priority, MethodExecution execution = MethodExecution::POOLED) {
+		return { Message::METHOD, Message::IS_REQUEST, priority, execution, &LSPServer::invoke<Message, Handler> };
+	}
+	template <typename Message, auto Handler>
+	static AsyncTask<void> invoke(LSPServer& server, json& msg, CancellationToken token);
+
+	void readerLoop(MessageQueue& queue);
+	// معالجة ما يجب قبل الطابور؛ يعيد false إذا استُهلكت الرسالة ($/cancelRequest)
+	bool admitMessage(json& msg);
+	// تنفيذ عناصر دفعة JSON-RPC بالتوازي وتجميع ردودها
+	void handleBatch(json batch);
+	// إضافة رد إلى دفعته إن كان ينتمي إلى دفعة؛ تُرسل الدفعة عند اكتمالها
+	bool collectBatchResponse(const json& id, std::string response);
+	void sendBatchResponses(const BatchResponse& batch);
+	bool isBatched(const json& id);
+	// تغليف مهمة لاحتسابها ضمن مهام الجلسة الجارية
+	ThreadPool::Task track(ThreadPool::Task task);
+	// تشغيل معالج كمهمة من مهام الجلسة حتى انتهائه (حتى لو تعلق)؛ onDone عند انتهائه
+	void launch(AsyncTask<void> task, std::function<void()> onDone = nullptr);
+	void finishTask();
+	// التحقق من حالة دورة الحياة قبل تنفيذ الطريقة؛ يعيد false إذا رُفضت الرسالة
+	bool checkLifecycle(const std::string& method, const json& msg);
+	// المعالجات قد تكون روتينات مشتركة: المراجع تبقى صالحة لأن المستدعي ينتظرها بـ co_await.
+	// الرسالة قابلة للتعديل لينقل فك المعاملات نصوص المستندات منها دون نسخ
+	AsyncTask<void> runMessage(const MethodEntry* entry, std::shared_ptr<json> message);
+	static std::string documentUri(const json& msg);
+	// تنفيذ الرسالة على سلسلة المستند؛ السلسلة محجوزة لها حتى انتهاء معالجها ولو تعلق
+	void postToDocument(const std::string& uri, const MethodEntry* entry, std::shared_ptr<json> message);
+	void releaseStrand(const std::string& uri);
+	// دمج didChange مع الدفعة المفتوحة للمستند أو جدولة دفعة جديدة
+	void postDocumentChange(const std::string& uri, std::shared_ptr<json> message);
+	void applyChangeBatch(const std::shared_ptr<ChangeBatch>& batch);
+	// تطبيق تعديلات رسائل didChange المتتالية على المستند دفعة واحدة
+	void applyDocumentChanges(std::vector<lsp::DidChangeTextDocumentParams>& batch);
+	// إيقاف القراءة وتفريغ الطابور وإنهاء الكتابة خلال المهلة
+	int drain(MessageQueue& queue, bool readerFinished);
+	// std::_Exit لا يُفرغ مخازن stdio: يُستدعى قبله كي لا يضيع آخر ما سُجّل
+	void flushRecorder();
+	// إرسال رسالة؛ رد الطلب لا يُرسل إلا مرة واحدة (يعيد false إن سبقه رد آخر)
+	bool sendResponse(const json& response);
+	// رد بنتيجة مسلسلة مسبقاً بنفس ضمان الرد الواحد
+	bool sendSerializedResult(const json& id, std::string_view result);
+	// رد يكتب writeResult نتيجته تدفقياً في مخزن الإخراج دون بناء شجرة json
+	bool sendStreamedResult(const json& id, const std::function<void(JsonStream&)>& writeResult);
 	void sendErrorResponse(const json& id, int code, const std::string& message);
-	void initialize(const json& params);
-	void handleCompletion(const json& params, const json& id);
+	void initialize(const lsp::InitializeParams& params, const json& id, CancellationToken token);
+	// اختيار أرخص الأنماط مما يدعمه العميل والخادم معاً
+	static NegotiatedCapabilities negotiate(const lsp::ClientCapabilities& client);
+	void handleShutdown(const json& id, CancellationToken token);
+	void handleExit();
+	void handleMetrics(const json& id, CancellationToken token);
+	void handleCancel(const lsp::CancelParams& params);
+	void handleDidOpen(lsp::DidOpenTextDocumentParams& params);
+	void handleDidChange(lsp::DidChangeTextDocumentParams& params);
+	void handleDidClose(const lsp::DidCloseTextDocumentParams& params);
+	// ربط الجلسة بفهرس مجلد الجذر المشترك (وبناؤه في الخلفية إن كان جديداً)
+	void attachWorkspace(const lsp::InitializeParams& params);
+	// قراءة نص المستند: نسخة الجلسة المفتوحة أو نسخة فهرس مساحة العمل.
+	// reader يُستدعى تحت قفل القراءة (أو لا شيء للتحقق من الوجود فقط)؛ false إن لم يُعرف المستند
+	AsyncTask<bool> findDocument(const std::string& uri, const std::function<void(const std::string&)>& reader = nullptr);
+	AsyncTask<void> handleCompletion(const lsp::CompletionParams& params, const json& id, CancellationToken token);
+	void handleCompletionResolve(lsp::CompletionItem& item, const json& id, CancellationToken token);
+	// إلغاء طلب الإكمال السابق لنفس المستند والرد عليه فوراً
+	void supersedeCompletion(const std::string& uri, const json& id);
+	void finishCompletion(const std::string& uri, const json& id);
+	// الرد على طلب ملغى بالرمز RequestCancelled
+	void sendCancelledResponse(const json& id);
 	bool isValidLSPMessage(const json& msg);
 };
@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "MessageReader.h"
+
+// اتجاه الرسالة المسجلة
+enum class RecordDirection {
+	INBOUND = 0,  // من المحرر إلى الخادم
+	OUTBOUND      // من الخادم إلى المحرر
+};
+
+// مسجل الجلسة - يحفظ كل رسالة مقطّعة مع وقتها منذ بدء التسجيل لإعادة تشغيلها
+// لاحقاً. كل سجل سطر "<in|out> <microseconds> <length>\r\n" يليه المحتوى كما هو ثم "\r\n"
+class SessionRecorder {
+public:
+	struct Entry {
+		RecordDirection direction = RecordDirection::INBOUND;
+		int64_t timestamp = 0;  // ميكروثانية منذ بدء التسجيل
+		std::string body;
+	};
+
+	SessionRecorder() = default;
+	~SessionRecorder();
+
+	SessionRecorder(const SessionRecorder&) = delete;
+	SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+	// فتح ملف التسجيل (يُستبدل إن وُجد)
+	bool open(const std::string& path);
+	void close();
+	// إفراغ المخزن إلى الملف؛ يُستدعى قبل الخروج دون close (std::_Exit)
+	void flush();
+
+	// آمنة للاستدعاء من عدة خيوط
+	void record(RecordDirection direction, std::string_view body);
+	void record(RecordDirection direction, const MessageBody& body);
+
+	// قراءة السجل التالي من ملف تسجيل؛ يعيد false عند النهاية أو إذا كان السجل تالفاً
+	static bool readEntry(std::FILE* file, Entry& entry);
+
+private:
+	// مخزن الملف كبير لأن الرسائل تُكتب من مسار المعالجة
+	static constexpr size_t FILE_BUFFER_SIZE = 1024 * 1024;
+
+	std::mutex mutex;
+	std::FILE* file = nullptr;
+	std::chrono::steady_clock::time_point start;
+
+	void writeHeader(RecordDirection direction, size_t length);
+};
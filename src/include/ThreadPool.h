@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// فئات أولوية المهام: الطلبات التفاعلية لا تنتظر خلف التحليل في الخلفية
+enum class TaskPriority {
+	INTERACTIVE = 0,  // إكمال، تلميحات... يريد المستخدم نتيجتها فوراً
+	NORMAL,           // إشعارات المستندات وبقية الطلبات
+	BACKGROUND        // تحليل وفهرسة وتشخيصات
+};
+
+constexpr size_t TASK_PRIORITY_COUNT = 3;
+
+const char* priorityToString(TaskPriority priority);
+
+// مجمّع خيوط عمل مع سرقة المهام: لكل خيط طابوره الخاص، ويسرق الخيط
+// الخامل من طوابير الآخرين. تُختار المهام حسب الأولوية مع حماية من التجويع:
+// المهمة التي تتجاوز مهلة انتظار فئتها تُقدَّم على الفئات الأعلى
+class ThreadPool {
+public:
+	using Task = std::function<void()>;
+	using Clock = std::chrono::steady_clock;
+
+	// threadCount = 0 يعني حسب عدد أنوية المعالج
+	explicit ThreadPool(size_t threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void start();
+	// إيقاف الخيوط بعد إنهاء المهام الجارية (المهام المتبقية تُهمل)
+	void stop();
+
+	// إضافة مهمة؛ من داخل خيط عامل تُضاف إلى طابوره الخاص
+	void submit(Task task, TaskPriority priority = TaskPriority::NORMAL);
+
+	// نقطة استباق للمهام الطويلة: هل توجد مهام أعلى أولوية من المهمة الجارية
+	// بانتظار التنفيذ؟ على المهمة حينها حفظ حالتها وإعادة جدولة بقيتها
+	static bool shouldYield();
+	// أولوية المهمة الجارية على الخيط الحالي
+	static TaskPriority currentTaskPriority() { return currentPriority; }
+
+	size_t threadCount() const { return workers.size(); }
+
+private:
+	// أقصى انتظار لكل فئة قبل تقديمها على الفئات الأعلى
+	static constexpr std::chrono::milliseconds STARVATION_LIMIT[TASK_PRIORITY_COUNT] = {
+		std::chrono::milliseconds(0),
+		std::chrono::milliseconds(100),
+		std::chrono::milliseconds(500)
+	};
+
+	struct QueuedTask {
+		Task task;
+		TaskPriority priority = TaskPriority::NORMAL;
+		Clock::time_point enqueuedAt{};
+	};
+
+	struct Worker {
+		std::mutex mutex;
+		std::deque<QueuedTask> tasks[TASK_PRIORITY_COUNT];
+		std::thread thread;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	std::atomic<size_t> queuedTasks{ 0 };    // مهام في الطوابير لم تبدأ
+	std::atomic<size_t> queuedByPriority[TASK_PRIORITY_COUNT]{};
+	std::atomic<size_t> nextWorker{ 0 };
+	// أولوية المهمة الجارية على الخيط الحالي (لنقاط الاستباق)
+	static thread_local TaskPriority currentPriority;
+	bool stopping = false;
+	bool running = false;
+
+	void workerLoop(size_t index);
+	// أخذ مهمة من الطابور الخاص (الأحدث أولاً) أو سرقتها من غيره (الأقدم أولاً)
+	bool takeTask(size_t index, QueuedTask& task);
+	// أخذ أقدم مهمة تجاوزت مهلة انتظار فئتها إن وجدت
+	bool takeStarvedTask(QueuedTask& task);
+	bool popFrom(Worker& worker, size_t priority, bool newest, QueuedTask& task);
+	void runTask(QueuedTask& task);
+
+	friend class Strand;
+};
+
+// سلسلة تنفيذ (strand) - تنفذ مهامها بالتتابع على مجمّع الخيوط
+// تُستخدم لكل مستند لضمان ترتيب رسائل LSP الخاصة به
+class Strand : public std::enable_shared_from_this<Strand> {
+public:
+	// يُستدعى مرة واحدة عند انتهاء مهمة غير متزامنة
+	using Done = std::function<void()>;
+	using SuspendableTask = std::function<void(Done done)>;
+
+	explicit Strand(ThreadPool& pool) : pool(pool) {}
+
+	void post(ThreadPool::Task task, TaskPriority priority = TaskPriority::NORMAL);
+	// مهمة قد تتعلق (روتين ينتظر شيئاً): السلسلة تبقى محجوزة لها حتى تستدعي done،
+	// فلا تبدأ المهمة التالية قبل انتهائها ولو استؤنفت على خيط آخر
+	void postAsync(SuspendableTask task, TaskPriority priority = TaskPriority::NORMAL);
+	// لا توجد مهام بانتظار التنفيذ
+	bool empty() const;
+
+private:
+	// أقصى عدد من المهام المتتالية قبل إعادة الجدولة لإفساح المجال لغيرها
+	static constexpr size_t MAX_BATCH = 16;
+
+	struct StrandTask {
+		ThreadPool::Task task;
+		SuspendableTask asyncTask;
+		TaskPriority priority;
+	};
+
+	// حالة المهمة غير المتزامنة الجارية
+	enum class AsyncState {
+		NONE,
+		CALLING,    // ما زالت في استدعائها الأول داخل التصريف
+		SUSPENDED,  // تعلقت: التصريف توقف والسلسلة محجوزة حتى done
+		FINISHED    // انتهت قبل عودة استدعائها الأول
+	};
+
+	ThreadPool& pool;
+	mutable std::mutex mutex;
+	std::deque<StrandTask> tasks;
+	bool running = false;
+	AsyncState asyncState = AsyncState::NONE;
+	// أولوية أعلى تصريف مجدول لم يبدأ بعد (أو لا شيء)
+	bool scheduled = false;
+	TaskPriority scheduledPriority = TaskPriority::BACKGROUND;
+
+	// الترتيب داخل السلسلة ثابت، لكن أولوية التصريف تتبع أهم مهمة في انتظاره
+	void schedule(TaskPriority priority);
+	void drain();
+	// يُستدعى والقفل محجوز: إنهاء التصريف وجدولة ما تبقى من المهام
+	void release();
+	void finishAsync();
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+
+// فهرس مساحة العمل - ملفات ألف الموجودة على القرص تحت مجلد جذر واحد.
+// يحفظ لكل ملف حجمه ووقت تعديله فقط، ويُقرأ النص من القرص عند طلبه، فلا
+// تبقى نصوص المشروع في الذاكرة. يُبنى مرة ويُشارك بين كل العملاء الذين
+// يفتحون نفس المجلد، بينما تبقى المستندات المفتوحة في طبقة خاصة بكل عميل فوقه.
+// يُحدّث بمسح يقارن حجم كل ملف ووقت تعديله بما سُجّل سابقاً
+class WorkspaceIndex : public std::enable_shared_from_this<WorkspaceIndex> {
+public:
+	// الفهرس المشترك لمجلد الجذر؛ يُنشأ عند أول طلب بعد تحرر سابقه
+	// created = true يعني أن على المستدعي استدعاء build()، وإلا فـ refresh()
+	static std::shared_ptr<WorkspaceIndex> acquire(const std::string& rootUri, bool& created);
+
+	// تحويل URI بصيغة file:// إلى مسار محلي والعكس (فارغ إن لم يكن ملفاً محلياً)
+	static std::string uriToPath(const std::string& uri);
+	static std::string pathToUri(const std::string& path);
+
+	explicit WorkspaceIndex(const std::string& rootUri);
+	~WorkspaceIndex();
+
+	// مسح المجلد وتسجيل الملفات كمهام خلفية على المجمّع؛ يُستدعى مرة واحدة.
+	// المسح يتنازل عن خيطه بين الملفات متى انتظرت مهام أعلى أولوية ويكمل بمهمة جديدة
+	void build(ThreadPool& pool);
+	// مسح جديد يسجل ما ظهر على القرص ويحذف ما اختفى
+	void refresh(ThreadPool& pool);
+	// تحديث سجل ملف واحد (مثلاً بعد أن أغلقه عميل حفظه)
+	void refreshFile(const std::string& uri);
+	bool isReady() const { return ready.load(std::memory_order_acquire); }
+
+	// انتظار اكتمال البناء دون حجز خيط: co_await index.whenReady(pool)
+	// يعلق الروتين ويستأنفه على المجمّع بعد انتهاء build()
+	struct ReadyAwaiter {
+		WorkspaceIndex& index;
+		ThreadPool& pool;
+		TaskPriority priority;
+		bool await_ready() const noexcept { return index.isReady(); }
+		bool await_suspend(std::coroutine_handle<> handle) { return index.addWaiter(handle, pool, priority); }
+		void await_resume() const noexcept {}
+	};
+	ReadyAwaiter whenReady(ThreadPool& pool, TaskPriority priority = TaskPriority::NORMAL) {
+		return { *this, pool, priority };
+	}
+
+	// هل الملف مفهرس؛ لا يقرأ القرص
+	bool contains(const std::string& uri) const;
+	// قراءة نص الملف المفهرس من القرص وتمريره للقارئ؛ false إن لم يكن مفهرساً أو تعذرت قراءته
+	template <typename Reader>
+	bool withDocumentText(const std::string& uri, Reader&& reader) const {
+		std::string text;
+		if (!readFile(uri, text)) {
+			return false;
+		}
+		std::forward<Reader>(reader)(static_cast<const std::string&>(text));
+		return true;
+	}
+	size_t getFileCount() const;
+	const std::string& getRootUri() const { return rootUri; }
+
+private:
+	// الملفات الأكبر من هذا لا تُسجّل في الفهرس
+	static constexpr size_t MAX_FILE_SIZE = 16 * 1024 * 1024;
+	// حد عدد الملفات المسجلة؛ المسح يتوقف عنده فلا ينمو الفهرس بلا سقف
+	static constexpr size_t MAX_FILES = 100000;
+
+	std::string rootUri;
+	std::string rootPath;
+	std::atomic<bool> ready{ false };
+
+	// حالة المسح بين مهامه المتتالية (لا تعمل منها إلا واحدة في كل لحظة)
+	struct Scan;
+	std::unique_ptr<Scan> scan;
+	std::atomic<bool> scanning{ false };
+	// رقم المسح الجاري؛ الملفات التي لم يرها المسح المكتمل حُذفت من القرص
+	std::atomic<uint64_t> generation{ 0 };
+
+	// حالة كل ملف عند آخر مسح، مفهرسة بـ URI موحد عبر pathToUri لتطابق
+	// صيغ الترميز المختلفة للعملاء
+	struct FileStamp {
+		uintmax_t size = 0;
+		std::filesystem::file_time_type modified{};
+		uint64_t generation = 0;
+	};
+	mutable std::mutex stampsMutex;
+	std::unordered_map<std::string, FileStamp> stamps;
+
+	void startScan(ThreadPool& pool);
+	void continueScan(ThreadPool& pool);
+	// تسجيل الملف إن كان جديداً أو تغير؛ يعيد true إذا سُجّل
+	bool recordFile(const std::filesystem::path& path);
+	size_t removeUnseen();
+	bool readFile(const std::string& uri, std::string& text) const;
+
+	// الروتينات المعلقة بانتظار اكتمال البناء
+	struct Waiter {
+		std::coroutine_handle<> handle;
+		ThreadPool* pool;
+		TaskPriority priority;
+	};
+	std::mutex waitersMutex;
+	std::vector<Waiter> waiters;
+
+	// يعيد false إذا اكتمل البناء في هذه الأثناء (يُستأنف الروتين فوراً)
+	bool addWaiter(std::coroutine_handle<> handle, ThreadPool& pool, TaskPriority priority);
+	void markReady();
+};
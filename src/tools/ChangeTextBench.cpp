@@ -0,0 +1,130 @@
+// قياس تحليل رسائل didChange الكاملة لمصادر عربية كبيرة: محلل JSON وحده مقابل
+// ChangeTextScanner (فك النص بالمتجهات ثم تحليل الباقي) كما في LSPServer::parseMessage،
+// على المحتوى المتصل والمقسم على كتل
+
+#include "ChangeTextScanner.h"
+#include "JsonString.h"
+#include "MessageReader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+namespace {
+	std::string arabicSource(size_t size) {
+		std::string text;
+		const std::string lines[] = {
+			"دالة احسب_المجموع(قائمة):\n",
+			"\tالمجموع = ٠\n",
+			"\tلكل عنصر في قائمة:\n",
+			"\t\tالمجموع = المجموع + عنصر\n",
+			"\tارجع المجموع\n",
+			"اطبع(\"النتيجة: \" + نص(احسب_المجموع([١، ٢، ٣])))\n"
+		};
+		for (size_t i = 0; text.size() < size; ++i) {
+			text += lines[i % std::size(lines)];
+		}
+		return text;
+	}
+
+	std::string didChangeFull(const std::string& text) {
+		return json({
+			{"jsonrpc", "2.0"},
+			{"method", "textDocument/didChange"},
+			{"params", {
+				{"textDocument", {{"uri", "file:///home/user/project/src/main.alif"}, {"version", 42}}},
+				{"contentChanges", json::array({{{"text", text}}})}
+			}}
+		}).dump();
+	}
+
+	// نفس المحتوى مقسماً على كتل المجمّع كما يقرؤه MessageReader للرسائل الكبيرة
+	void fillChunked(ChunkPool& pool, const std::string& data, MessageBody& body) {
+		body.chunked = true;
+		body.chunks.reset(&pool, data.size());
+		size_t offset = 0;
+		while (!body.chunks.complete()) {
+			size_t count = body.chunks.writableSize();
+			std::memcpy(body.chunks.writableData(), data.data() + offset, count);
+			body.chunks.commit(count);
+			offset += count;
+		}
+	}
+
+	template <typename Parse>
+	double measure(size_t count, Parse parse) {
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; ++i) {
+			parse();
+		}
+		return std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count() / static_cast<double>(count);
+	}
+
+	void report(const char* name, size_t bytes, double millis) {
+		std::printf("%-28s %9.3f ms  %8.1f MB/s\n", name, millis,
+			static_cast<double>(bytes) / (1024.0 * 1024.0) / (millis / 1000.0));
+	}
+
+	std::string fullParse(const MessageBody& body) {
+		json message = body.chunked ? json::parse(body.chunks.begin(), body.chunks.end())
+			: json::parse(body.data.data(), body.data.data() + body.data.size());
+		return std::move(message["params"]["contentChanges"][0]["text"].get_ref<std::string&>());
+	}
+
+	std::string fastParse(const MessageBody& body) {
+		ChangeTexts changes;
+		if (!ChangeTextScanner::extract(body, changes)) {
+			return {};
+		}
+		json message = json::parse(changes.skeleton, nullptr, false);
+		if (message.is_discarded() || !ChangeTextScanner::restore(message, changes.texts)) {
+			return {};
+		}
+		return std::move(message["params"]["contentChanges"][0]["text"].get_ref<std::string&>());
+	}
+
+	bool run(const char* layout, const MessageBody& body, const std::string& expected, size_t count) {
+		if (fullParse(body) != expected || fastParse(body) != expected) {
+			std::printf("%s: decoded text does not match the source\n", layout);
+			return false;
+		}
+		std::printf("%s (%zu bytes)\n", layout, body.size());
+		report("  json::parse", body.size(), measure(count, [&body] { fullParse(body); }));
+		report("  ChangeTextScanner", body.size(), measure(count, [&body] { fastParse(body); }));
+		return true;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50;
+	size_t textSize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1024 * 1024;
+
+	std::string text = arabicSource(textSize);
+	std::string message = didChangeFull(text);
+	std::printf("%zu full didChange parses of a %zu byte Arabic source\n\n", count, text.size());
+
+	// فك النص وحده (ما بعد علامة التنصيص الافتتاحية)
+	size_t quote = message.find("\"text\":\"") + 8;
+	std::string_view escaped = std::string_view(message).substr(quote);
+	report("decode only", escaped.size(), measure(count, [escaped] {
+		std::string decoded;
+		decoded.reserve(escaped.size());
+		size_t consumed = 0;
+		JsonStringDecoder(&decoded).feed(escaped, consumed);
+	}));
+	std::printf("\n");
+
+	MessageBody contiguous;
+	contiguous.data = message;
+	ChunkPool pool;
+	MessageBody chunked;
+	fillChunked(pool, message, chunked);
+
+	bool matched = run("contiguous", contiguous, text, count);
+	matched = run("chunked", chunked, text, count) && matched;
+	return matched ? 0 : 1;
+}
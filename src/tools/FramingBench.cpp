@@ -0,0 +1,145 @@
+// قياس أداء قراءة رسائل LSP: الطريقة القديمة (getline + cin.read على stdin
+// غير مخزّن) مقابل MessageReader، على دفعة من رسائل didChange
+
+#include "MessageReader.h"
+#include "json.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+namespace {
+	struct BenchResult {
+		size_t messages = 0;
+		double seconds = 0;
+	};
+
+	// إنشاء ملف يحتوي على count رسالة didChange متتالية
+	std::string buildStream(size_t count, size_t textSize) {
+		std::string text;
+		const std::string line = "دالة مثال(س):\n\tارجع س + ١\n";
+		while (text.size() < textSize) {
+			text += line;
+		}
+
+		std::string stream;
+		for (size_t i = 0; i < count; ++i) {
+			json msg = {
+				{"jsonrpc", "2.0"},
+				{"method", "textDocument/didChange"},
+				{"params", {
+					{"textDocument", {{"uri", "file:///bench.alif"}, {"version", i}}},
+					{"contentChanges", json::array({{{"text", text}}})}
+				}}
+			};
+			std::string body = msg.dump();
+			stream += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+		}
+		return stream;
+	}
+
+	// الطريقة القديمة كما كانت في LSPServer::run
+	BenchResult runLegacy(bool parse) {
+		BenchResult result{};
+		auto start = std::chrono::steady_clock::now();
+		while (true) {
+			std::string line;
+			size_t length = 0;
+			bool contentLengthFound = false;
+			while (std::getline(std::cin, line)) {
+				if (!line.empty() && line.back() == '\r') {
+					line.pop_back();
+				}
+				if (line.find("Content-Length: ") == 0) {
+					length = std::stoul(line.substr(16));
+					contentLengthFound = true;
+				}
+				if (line.empty()) {
+					break;
+				}
+			}
+			if (!contentLengthFound) {
+				break;
+			}
+			std::vector<char> buffer(length);
+			std::cin.read(buffer.data(), length);
+			if (!std::cin) {
+				break;
+			}
+			if (parse) {
+				json msg = json::parse(buffer.begin(), buffer.end());
+			}
+			++result.messages;
+		}
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+	BenchResult runFramed(bool parse, size_t& syscalls) {
+		BenchResult result{};
+		MessageReader reader(0);
+		auto start = std::chrono::steady_clock::now();
+		MessageBody body;
+		while (reader.read(body) == ReadStatus::MESSAGE) {
+			if (parse) {
+				json msg = json::parse(body.data.data(), body.data.data() + body.data.size());
+			}
+			++result.messages;
+		}
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		syscalls = reader.syscallCount();
+		return result;
+	}
+
+	// إعادة stdin إلى بداية الملف قبل كل جولة
+	void rewindInput() {
+		lseek(0, 0, SEEK_SET);
+		clearerr(stdin);
+		std::cin.clear();
+	}
+
+	void report(const char* name, const BenchResult& r) {
+		std::printf("%-24s %8zu msgs  %8.3f s  %12.0f msgs/s\n",
+			name, r.messages, r.seconds, r.messages / r.seconds);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+	size_t textSize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 512;
+
+	std::string stream = buildStream(count, textSize);
+	char path[] = "/tmp/alif-lsp-bench-XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0 || write(fd, stream.data(), stream.size()) != static_cast<ssize_t>(stream.size())) {
+		std::perror("Cannot create bench input");
+		return 1;
+	}
+	unlink(path);
+	dup2(fd, 0);
+	close(fd);
+	setvbuf(stdin, nullptr, _IONBF, 0);
+
+	std::printf("%zu didChange messages, %zu bytes of text each (%zu bytes total)\n\n",
+		count, textSize, stream.size());
+
+	size_t syscalls = 0;
+	rewindInput();
+	report("legacy framing", runLegacy(false));
+	rewindInput();
+	BenchResult framed = runFramed(false, syscalls);
+	report("MessageReader framing", framed);
+	std::printf("%-24s %8zu read(2) calls\n\n", "", syscalls);
+
+	rewindInput();
+	report("legacy framing+parse", runLegacy(true));
+	rewindInput();
+	report("MessageReader+parse", runFramed(true, syscalls));
+	return 0;
+}
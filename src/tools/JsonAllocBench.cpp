@@ -0,0 +1,210 @@
+// قياس تخصيصات الذاكرة وزمن تحليل رسائل LSP بنوع json في الخادم، مقابل ساحة
+// بتقديم المؤشر معرّفة هنا فقط للمقارنة. الخادم لا يستخدم الساحة: هذه الأداة
+// هي ما يُبنى عليه قرار إبقائها خارجه. النصوص والمفاتيح تبقى على الكومة في الحالتين
+// لأن string_t هو std::string بمخصّصه الافتراضي
+
+#include "Json.h"
+#include "ChangeTextScanner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// عدّ التخصيصات باستبدال operator new؛ GCC ينبّه على free داخل operator delete المستبدل
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+	std::atomic<size_t> allocations{ 0 };
+
+	// ساحة لرسالة واحدة على الخيط الحالي: تُصفّر بعد إتلاف الرسالة، والتحرير لا يفعل شيئاً
+	struct BumpArena {
+		static constexpr size_t SIZE = 256 * 1024;
+		std::unique_ptr<char[]> memory{ new char[SIZE] };
+		size_t used = 0;
+	};
+	thread_local BumpArena arena;
+
+	template <typename T>
+	struct BumpAllocator {
+		using value_type = T;
+
+		BumpAllocator() noexcept = default;
+		template <typename U>
+		BumpAllocator(const BumpAllocator<U>&) noexcept {}
+
+		T* allocate(size_t count) {
+			size_t bytes = (count * sizeof(T) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+			if (arena.used + bytes > BumpArena::SIZE) {
+				throw std::bad_alloc();
+			}
+			T* pointer = reinterpret_cast<T*>(arena.memory.get() + arena.used);
+			arena.used += bytes;
+			return pointer;
+		}
+		void deallocate(T*, size_t) noexcept {}
+
+		template <typename U>
+		bool operator==(const BumpAllocator<U>&) const noexcept { return true; }
+		template <typename U>
+		bool operator!=(const BumpAllocator<U>&) const noexcept { return false; }
+	};
+
+	using ArenaJson = nlohmann::basic_json<std::map, std::vector, std::string, bool, std::int64_t, std::uint64_t, double,
+		BumpAllocator>;
+
+	struct BenchResult {
+		double allocationsPerMessage = 0;
+		double microsPerMessage = 0;
+	};
+
+	const char* const URI = "file:///home/user/project/src/main.alif";
+
+	std::string didChangeIncremental() {
+		return json({
+			{"jsonrpc", "2.0"},
+			{"method", "textDocument/didChange"},
+			{"params", {
+				{"textDocument", {{"uri", URI}, {"version", 42}}},
+				{"contentChanges", json::array({{
+					{"range", {{"start", {{"line", 10}, {"character", 4}}}, {"end", {{"line", 10}, {"character", 4}}}}},
+					{"text", "س"}
+				}})}
+			}}
+		}).dump();
+	}
+
+	std::string didChangeFull(size_t textSize) {
+		std::string text;
+		const std::string line = "دالة مثال(س):\n\tارجع س + ١\n";
+		while (text.size() < textSize) {
+			text += line;
+		}
+		return json({
+			{"jsonrpc", "2.0"},
+			{"method", "textDocument/didChange"},
+			{"params", {
+				{"textDocument", {{"uri", URI}, {"version", 42}}},
+				{"contentChanges", json::array({{{"text", text}}})}
+			}}
+		}).dump();
+	}
+
+	std::string completion() {
+		return json({
+			{"jsonrpc", "2.0"},
+			{"id", 117},
+			{"method", "textDocument/completion"},
+			{"params", {
+				{"textDocument", {{"uri", URI}}},
+				{"position", {{"line", 10}, {"character", 5}}},
+				{"context", {{"triggerKind", 1}}}
+			}}
+		}).dump();
+	}
+
+	// وسيط الأزمنة عبر عدة جولات؛ التخصيصات ثابتة بين الجولات
+	template <typename Parse>
+	BenchResult measure(size_t count, size_t rounds, Parse parse) {
+		std::vector<double> times;
+		BenchResult result;
+		for (size_t round = 0; round < rounds; ++round) {
+			size_t before = allocations.load();
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; ++i) {
+				parse();
+			}
+			times.push_back(std::chrono::duration<double, std::micro>(
+				std::chrono::steady_clock::now() - start).count() / static_cast<double>(count));
+			result.allocationsPerMessage = static_cast<double>(allocations.load() - before) / static_cast<double>(count);
+		}
+		std::sort(times.begin(), times.end());
+		result.microsPerMessage = times[times.size() / 2];
+		return result;
+	}
+
+	void print(const char* name, size_t bytes, const BenchResult& heap, const BenchResult& bump) {
+		std::printf("%-26s %7zu bytes  json: %6.1f allocs %8.2f us   arena: %6.1f allocs %8.2f us\n",
+			name, bytes, heap.allocationsPerMessage, heap.microsPerMessage,
+			bump.allocationsPerMessage, bump.microsPerMessage);
+	}
+
+	void run(const char* name, const std::string& body, size_t count, size_t rounds) {
+		BenchResult heap = measure(count, rounds, [&body] {
+			json message = json::parse(body);
+		});
+		BenchResult bump = measure(count, rounds, [&body] {
+			{
+				ArenaJson message = ArenaJson::parse(body);
+			}
+			arena.used = 0;
+		});
+		print(name, body.size(), heap, bump);
+	}
+
+	// مسار didChange في الخادم: فصل النصوص ثم تحليل skeleton وإعادتها إليه
+	template <typename Json>
+	void parseChange(const std::string& body) {
+		MessageBody message;
+		message.data = body;
+		ChangeTexts changes;
+		if (!ChangeTextScanner::extract(message, changes)) {
+			std::abort();
+		}
+		Json parsed = Json::parse(changes.skeleton);
+		auto& contentChanges = parsed["params"]["contentChanges"];
+		for (size_t i = 0; i < changes.texts.size(); ++i) {
+			contentChanges[i]["text"].template get_ref<std::string&>() = std::move(changes.texts[i]);
+		}
+	}
+
+	void runFastPath(const char* name, const std::string& body, size_t count, size_t rounds) {
+		BenchResult heap = measure(count, rounds, [&body] { parseChange<json>(body); });
+		BenchResult bump = measure(count, rounds, [&body] {
+			parseChange<ArenaJson>(body);
+			arena.used = 0;
+		});
+		print(name, body.size(), heap, bump);
+	}
+}
+
+void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size ? size : 1)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+	std::free(pointer);
+}
+
+int main(int argc, char* argv[]) {
+	size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+	size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 7;
+	if (count == 0 || rounds == 0) {
+		std::fprintf(stderr, "Usage: alif-lsp-json-bench [messages] [rounds]\n");
+		return 1;
+	}
+
+	std::printf("%zu messages each (parse + destroy), median of %zu rounds\n\n", count, rounds);
+	run("didChange incremental", didChangeIncremental(), count, rounds);
+	run("didChange full 2KB", didChangeFull(2048), count, rounds);
+	runFastPath("didChange full 2KB (scan)", didChangeFull(2048), count, rounds);
+	run("completion", completion(), count, rounds);
+	return 0;
+}
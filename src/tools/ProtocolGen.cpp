@@ -0,0 +1,796 @@
+// مولد أنواع بروتوكول LSP: يقرأ metaModel.json (نموذج المواصفة الرسمي) ويكتب
+// Protocol.h وProtocol.cpp: بنية C++ لكل structure وliteral، وتعداد لكل enumeration
+// عددي، ودالتي decode/encode لكل بنية تمران على أعضاء الكائن مرة واحدة.
+// الناتج مُضمّن في المستودع؛ يُعاد توليده بـ make protocol بعد تعديل النموذج
+
+#include "json.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Model = nlohmann::ordered_json;
+
+namespace {
+	// نوع خاصية بعد حل المراجع والأسماء البديلة
+	struct Resolved {
+		std::string cpp;
+		// (T | null): القيمة الغائبة تُكتب null
+		bool nullable = false;
+		// شرط على قيمة json للاتحادات من الأنواع الأساسية (فارغ = أي قيمة)
+		std::string check;
+		// البنى المحتواة بالقيمة، تُعرَّف قبل البنية المستخدمة لها
+		std::vector<std::string> dependencies;
+	};
+
+	struct Property {
+		std::string name;
+		std::string field;
+		Resolved type;
+		bool optional = false;
+		std::string documentation;
+	};
+
+	struct Structure {
+		std::string name;
+		std::vector<Property> properties;
+		std::string documentation;
+	};
+
+	struct Request {
+		std::string typeName;
+		std::string method;
+		std::string params;
+		bool isRequest = false;
+		std::string documentation;
+	};
+
+	class Generator {
+	public:
+		explicit Generator(const Model& model) : model(model) {}
+
+		bool run(std::ostream& header, std::ostream& source);
+
+	private:
+		const Model& model;
+		std::map<std::string, const Model*> structures;
+		std::map<std::string, const Model*> enumerations;
+		std::map<std::string, const Model*> aliases;
+		// البنى المولدة: من النموذج ومن literal والاتحادات (بترتيب الإنشاء)
+		std::map<std::string, Structure> generated;
+		std::vector<std::string> order;
+		// الخصائص المعلنة في كل بنية من النموذج (دون الموروثة)
+		std::map<std::string, std::vector<Property>> declared;
+		std::vector<std::string> errors;
+
+		Resolved resolve(const Model& type, const std::string& context);
+		Resolved resolveBase(const std::string& name);
+		Resolved mergeAlternatives(const std::vector<const Model*>& items, const std::string& name);
+		const std::vector<Property>& declaredProperties(const std::string& name);
+		std::vector<Property> flatten(const std::string& name);
+		std::vector<Property> literalProperties(const Model& literal, const std::string& context);
+		void addStructure(Structure structure);
+		void sortStructures(const std::string& name, std::set<std::string>& visited, std::vector<std::string>& sorted);
+
+		void writeHeader(std::ostream& out, const std::vector<std::string>& sorted, const std::vector<Request>& requests);
+		void writeSource(std::ostream& out, const std::vector<std::string>& sorted);
+	};
+
+	const std::set<std::string> KEYWORDS = {
+		"auto", "bool", "break", "case", "char", "class", "const", "default", "delete", "do",
+		"double", "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend",
+		"goto", "if", "inline", "int", "long", "namespace", "new", "operator", "private", "protected",
+		"public", "register", "return", "short", "signed", "sizeof", "static", "struct", "switch",
+		"template", "this", "throw", "true", "try", "typedef", "typename", "union", "unsigned",
+		"using", "virtual", "void", "volatile", "while"
+	};
+
+	std::string identifier(const std::string& name) {
+		return KEYWORDS.count(name) ? name + "_" : name;
+	}
+
+	std::string capitalize(std::string name) {
+		if (!name.empty() && name[0] >= 'a' && name[0] <= 'z') {
+			name[0] = static_cast<char>(name[0] - 'a' + 'A');
+		}
+		return name;
+	}
+
+	// اسم البنى الداخلية في النموذج (_InitializeParams) دون الشرطة المحجوزة في C++
+	std::string publicName(const std::string& name) {
+		return !name.empty() && name[0] == '_' ? name.substr(1) : name;
+	}
+
+	// الجملة الأولى من التوثيق كتعليق في سطر واحد
+	std::string firstLine(const Model& node) {
+		if (!node.contains("documentation")) {
+			return "";
+		}
+		std::string text = node["documentation"].get<std::string>();
+		text = text.substr(0, text.find("\n\n"));
+		std::replace(text.begin(), text.end(), '\n', ' ');
+		// نهاية الجملة نقطة يليها حرف كبير (لا اختصار مثل e.g.)
+		for (size_t end = text.find(". "); end != std::string::npos; end = text.find(". ", end + 1)) {
+			bool abbreviation = end >= 3 && (text.compare(end - 3, 3, "e.g") == 0 || text.compare(end - 3, 3, "i.e") == 0);
+			if (!abbreviation && end + 2 < text.size() && text[end + 2] >= 'A' && text[end + 2] <= 'Z') {
+				return text.substr(0, end + 1);
+			}
+		}
+		return text;
+	}
+
+	std::string fieldType(const Property& property) {
+		if (property.optional || property.type.nullable) {
+			return "std::optional<" + property.type.cpp + ">";
+		}
+		return property.type.cpp;
+	}
+}
+
+Resolved Generator::resolveBase(const std::string& name) {
+	Resolved type;
+	if (name == "string" || name == "DocumentUri" || name == "URI" || name == "RegExp") {
+		type.cpp = "std::string";
+	}
+	else if (name == "integer") {
+		type.cpp = "int32_t";
+	}
+	else if (name == "uinteger") {
+		type.cpp = "uint32_t";
+	}
+	else if (name == "decimal") {
+		type.cpp = "double";
+	}
+	else if (name == "boolean") {
+		type.cpp = "bool";
+	}
+	else {
+		type.cpp = "json";
+	}
+	return type;
+}
+
+Resolved Generator::resolve(const Model& type, const std::string& context) {
+	const std::string kind = type["kind"].get<std::string>();
+
+	if (kind == "base") {
+		return resolveBase(type["name"].get<std::string>());
+	}
+
+	if (kind == "reference") {
+		const std::string name = type["name"].get<std::string>();
+		if (structures.count(name)) {
+			Resolved resolved;
+			resolved.cpp = publicName(name);
+			resolved.dependencies.push_back(resolved.cpp);
+			return resolved;
+		}
+		if (enumerations.count(name)) {
+			const Model& enumeration = *enumerations[name];
+			// التعدادات النصية تقبل قيماً مخصصة فتبقى نصوصاً
+			if (enumeration["type"]["name"] == "string") {
+				return resolveBase("string");
+			}
+			Resolved resolved;
+			resolved.cpp = enumeration["name"].get<std::string>();
+			return resolved;
+		}
+		if (aliases.count(name)) {
+			if (name == "LSPAny" || name == "LSPObject" || name == "LSPArray") {
+				return resolveBase("json");
+			}
+			return resolve((*aliases[name])["type"], name);
+		}
+		errors.push_back("unknown reference " + name + " in " + context);
+		return resolveBase("json");
+	}
+
+	if (kind == "array") {
+		Resolved element = resolve(type["element"], context);
+		Resolved resolved;
+		resolved.cpp = "std::vector<" + (element.nullable ? "std::optional<" + element.cpp + ">" : element.cpp) + ">";
+		resolved.dependencies = element.dependencies;
+		return resolved;
+	}
+
+	if (kind == "literal") {
+		Structure structure;
+		structure.name = context;
+		structure.properties = literalProperties(type["value"], context);
+		addStructure(std::move(structure));
+		Resolved resolved;
+		resolved.cpp = context;
+		resolved.dependencies.push_back(context);
+		return resolved;
+	}
+
+	if (kind == "or") {
+		std::vector<const Model*> items;
+		bool nullable = false;
+		for (const Model& item : type["items"]) {
+			if (item["kind"] == "base" && item["name"] == "null") {
+				nullable = true;
+			}
+			else {
+				items.push_back(&item);
+			}
+		}
+
+		Resolved resolved;
+		if (items.size() == 1) {
+			resolved = resolve(*items[0], context);
+		}
+		else {
+			resolved = mergeAlternatives(items, context);
+		}
+		resolved.nullable = resolved.nullable || nullable;
+		return resolved;
+	}
+
+	// map وtuple وstringLiteral: تبقى قيم json
+	return resolveBase("json");
+}
+
+// اتحاد من literal أو بنى: بنية واحدة بكل الخصائص، والخاصية إلزامية فقط إن
+// لزمت في كل البدائل. اتحاد الأنواع الأساسية يبقى json مع التحقق من نوعه
+Resolved Generator::mergeAlternatives(const std::vector<const Model*>& items, const std::string& name) {
+	bool structural = true;
+	bool basic = true;
+	for (const Model* item : items) {
+		const std::string kind = (*item)["kind"].get<std::string>();
+		bool isStructure = kind == "literal" ||
+			(kind == "reference" && structures.count((*item)["name"].get<std::string>()));
+		structural = structural && isStructure;
+		basic = basic && kind == "base";
+	}
+
+	if (structural) {
+		std::vector<std::vector<Property>> alternatives;
+		for (const Model* item : items) {
+			if ((*item)["kind"] == "literal") {
+				alternatives.push_back(literalProperties((*item)["value"], name));
+			}
+			else {
+				alternatives.push_back(flatten((*item)["name"].get<std::string>()));
+			}
+		}
+
+		Structure structure;
+		structure.name = name;
+		for (const auto& alternative : alternatives) {
+			for (const Property& property : alternative) {
+				auto existing = std::find_if(structure.properties.begin(), structure.properties.end(),
+					[&property](const Property& p) { return p.name == property.name; });
+				if (existing == structure.properties.end()) {
+					structure.properties.push_back(property);
+				}
+				else if (existing->type.cpp != property.type.cpp) {
+					existing->type = resolveBase("json");
+				}
+			}
+		}
+		for (Property& property : structure.properties) {
+			for (const auto& alternative : alternatives) {
+				auto match = std::find_if(alternative.begin(), alternative.end(),
+					[&property](const Property& p) { return p.name == property.name; });
+				if (match == alternative.end() || match->optional) {
+					property.optional = true;
+				}
+			}
+		}
+		addStructure(std::move(structure));
+
+		Resolved resolved;
+		resolved.cpp = name;
+		resolved.dependencies.push_back(name);
+		return resolved;
+	}
+
+	Resolved resolved = resolveBase("json");
+	if (basic) {
+		std::vector<std::string> checks;
+		for (const Model* item : items) {
+			const std::string base = (*item)["name"].get<std::string>();
+			std::string check;
+			if (base == "integer" || base == "uinteger") {
+				check = "member->is_number_integer()";
+			}
+			else if (base == "decimal") {
+				check = "member->is_number()";
+			}
+			else if (base == "boolean") {
+				check = "member->is_boolean()";
+			}
+			else {
+				check = "member->is_string()";
+			}
+			if (std::find(checks.begin(), checks.end(), check) == checks.end()) {
+				checks.push_back(check);
+			}
+		}
+		for (size_t i = 0; i < checks.size(); ++i) {
+			resolved.check += (i > 0 ? " || " : "") + checks[i];
+		}
+	}
+	return resolved;
+}
+
+std::vector<Property> Generator::literalProperties(const Model& literal, const std::string& context) {
+	std::vector<Property> properties;
+	for (const Model& node : literal["properties"]) {
+		Property property;
+		property.name = node["name"].get<std::string>();
+		property.field = identifier(property.name);
+		property.type = resolve(node["type"], context + capitalize(property.name));
+		property.optional = node.value("optional", false);
+		property.documentation = firstLine(node);
+		properties.push_back(std::move(property));
+	}
+	return properties;
+}
+
+const std::vector<Property>& Generator::declaredProperties(const std::string& name) {
+	auto it = declared.find(name);
+	if (it == declared.end()) {
+		it = declared.emplace(name, literalProperties(*structures[name], publicName(name))).first;
+	}
+	return it->second;
+}
+
+// خصائص البنية مع ما ترثه عبر extends وmixins
+std::vector<Property> Generator::flatten(const std::string& name) {
+	const Model& structure = *structures[name];
+	std::vector<Property> properties;
+	for (const char* inheritance : { "extends", "mixins" }) {
+		if (!structure.contains(inheritance)) {
+			continue;
+		}
+		for (const Model& base : structure[inheritance]) {
+			std::vector<Property> inherited = flatten(base["name"].get<std::string>());
+			properties.insert(properties.end(), inherited.begin(), inherited.end());
+		}
+	}
+	const std::vector<Property>& own = declaredProperties(name);
+	properties.insert(properties.end(), own.begin(), own.end());
+	return properties;
+}
+
+void Generator::addStructure(Structure structure) {
+	if (generated.count(structure.name)) {
+		return;
+	}
+	order.push_back(structure.name);
+	generated.emplace(structure.name, std::move(structure));
+}
+
+void Generator::sortStructures(const std::string& name, std::set<std::string>& visited, std::vector<std::string>& sorted) {
+	if (!visited.insert(name).second) {
+		return;
+	}
+	for (const Property& property : generated[name].properties) {
+		for (const std::string& dependency : property.type.dependencies) {
+			sortStructures(dependency, visited, sorted);
+		}
+	}
+	sorted.push_back(name);
+}
+
+bool Generator::run(std::ostream& header, std::ostream& source) {
+	for (const Model& node : model["structures"]) {
+		structures[node["name"].get<std::string>()] = &node;
+	}
+	for (const Model& node : model["enumerations"]) {
+		enumerations[node["name"].get<std::string>()] = &node;
+	}
+	for (const Model& node : model["typeAliases"]) {
+		aliases[node["name"].get<std::string>()] = &node;
+	}
+
+	// البنى الداخلية (_InitializeParams) تُدمج في وارثيها ولا تُولَّد منفردة
+	for (const Model& node : model["structures"]) {
+		const std::string name = node["name"].get<std::string>();
+		if (name[0] == '_') {
+			continue;
+		}
+		Structure structure;
+		structure.name = name;
+		structure.properties = flatten(name);
+		structure.documentation = firstLine(node);
+		addStructure(std::move(structure));
+	}
+
+	std::vector<Request> requests;
+	for (const char* group : { "requests", "notifications" }) {
+		for (const Model& node : model[group]) {
+			Request request;
+			request.typeName = node["typeName"].get<std::string>();
+			request.method = node["method"].get<std::string>();
+			request.isRequest = std::string(group) == "requests";
+			request.documentation = firstLine(node);
+			if (node.contains("params")) {
+				request.params = resolve(node["params"], request.typeName + "Params").cpp;
+			}
+			requests.push_back(std::move(request));
+		}
+	}
+
+	if (!errors.empty()) {
+		for (const std::string& error : errors) {
+			std::fprintf(stderr, "metaModel: %s\n", error.c_str());
+		}
+		return false;
+	}
+
+	std::set<std::string> visited;
+	std::vector<std::string> sorted;
+	for (const std::string& name : order) {
+		sortStructures(name, visited, sorted);
+	}
+
+	writeHeader(header, sorted, requests);
+	writeSource(source, sorted);
+	return true;
+}
+
+void Generator::writeHeader(std::ostream& out, const std::vector<std::string>& sorted, const std::vector<Request>& requests) {
+	out << "// ملف مولد من src/protocol/metaModel.json بواسطة src/tools/ProtocolGen.cpp (make protocol)؛ لا يُعدل يدوياً\n"
+		<< "#pragma once\n"
+		<< "#include <cstdint>\n"
+		<< "#include <optional>\n"
+		<< "#include <string>\n"
+		<< "#include <string_view>\n"
+		<< "#include <vector>\n"
+		<< "#include \"Json.h\"\n"
+		<< "#include \"JsonStream.h\"\n\n"
+		<< "// أنواع LSP " << model["metaData"]["version"].get<std::string>() << " للرسائل التي يعالجها الخادم.\n"
+		<< "// decode يمر على أعضاء كل كائن مرة واحدة وينقل النصوص منه (فيبقى المصدر بنصوص فارغة)؛\n"
+		<< "// الأعضاء غير المعروفة تُتجاهل، ويعيد false لعضو إلزامي مفقود أو قيمة من نوع خاطئ.\n"
+		<< "// encode يكتب الخصائص بترتيب أسمائها كتسلسل json ويحذف الاختيارية الغائبة\n"
+		<< "namespace lsp {\n";
+
+	for (const Model& enumeration : model["enumerations"]) {
+		const std::string name = enumeration["name"].get<std::string>();
+		std::string documentation = firstLine(enumeration);
+		out << "\n";
+		if (!documentation.empty()) {
+			out << "// " << documentation << "\n";
+		}
+		if (enumeration["type"]["name"] == "string") {
+			out << "namespace " << name << " {\n";
+			for (const Model& value : enumeration["values"]) {
+				out << "\tinline constexpr std::string_view " << value["name"].get<std::string>()
+					<< " = \"" << value["value"].get<std::string>() << "\";\n";
+			}
+			out << "}\n";
+			continue;
+		}
+		out << "enum class " << name << " : " << resolveBase(enumeration["type"]["name"].get<std::string>()).cpp << " {\n";
+		for (size_t i = 0; i < enumeration["values"].size(); ++i) {
+			const Model& value = enumeration["values"][i];
+			out << "\t" << value["name"].get<std::string>() << " = " << value["value"].dump()
+				<< (i + 1 < enumeration["values"].size() ? ",\n" : "\n");
+		}
+		out << "};\n";
+	}
+
+	for (const std::string& name : sorted) {
+		const Structure& structure = generated[name];
+		out << "\n";
+		if (!structure.documentation.empty()) {
+			out << "// " << structure.documentation << "\n";
+		}
+		out << "struct " << name << " {\n";
+		for (const Property& property : structure.properties) {
+			if (!property.documentation.empty()) {
+				out << "\t// " << property.documentation << "\n";
+			}
+			out << "\t" << fieldType(property) << " " << property.field << "{};\n";
+		}
+		out << "};\n";
+	}
+
+	out << "\n";
+	for (const std::string& name : sorted) {
+		out << "bool decode(json& value, " << name << "& out);\n";
+		out << "void encode(JsonStream& out, const " << name << "& value);\n";
+	}
+
+	out << "\n// الطلبات والإشعارات: الطريقة ونوع معاملاتها (void لمن لا معاملات له)\n";
+	for (const Request& request : requests) {
+		out << "\n";
+		if (!request.documentation.empty()) {
+			out << "// " << request.documentation << "\n";
+		}
+		out << "struct " << request.typeName << " {\n"
+			<< "\tstatic constexpr std::string_view METHOD = \"" << request.method << "\";\n"
+			<< "\tstatic constexpr bool IS_REQUEST = " << (request.isRequest ? "true" : "false") << ";\n"
+			<< "\tusing Params = " << (request.params.empty() ? "void" : request.params) << ";\n"
+			<< "};\n";
+	}
+	out << "}\n";
+}
+
+void Generator::writeSource(std::ostream& out, const std::vector<std::string>& sorted) {
+	out << "// ملف مولد من src/protocol/metaModel.json بواسطة src/tools/ProtocolGen.cpp (make protocol)؛ لا يُعدل يدوياً\n"
+		<< "#include \"Protocol.h\"\n\n"
+		<< "#include <limits>\n"
+		<< "#include <type_traits>\n"
+		<< "#include <utility>\n\n\n"
+		<< "namespace lsp {\n"
+		<< R"(namespace {
+	// القوالب معلنة مسبقاً ليجد بعضها بعضاً في الأنواع المتداخلة (std::optional<std::vector<T>>)
+	template <typename T>
+	std::enable_if_t<std::is_enum_v<T>, bool> decodeValue(json& value, T& out);
+	template <typename T>
+	std::enable_if_t<std::is_class_v<T>, bool> decodeValue(json& value, T& out);
+	template <typename T>
+	bool decodeValue(json& value, std::optional<T>& out);
+	template <typename T>
+	bool decodeValue(json& value, std::vector<T>& out);
+	template <typename T>
+	std::enable_if_t<std::is_enum_v<T>, void> encodeValue(JsonStream& out, T value);
+	template <typename T>
+	std::enable_if_t<std::is_class_v<T>, void> encodeValue(JsonStream& out, const T& value);
+	template <typename T>
+	void encodeValue(JsonStream& out, const std::optional<T>& value);
+	template <typename T>
+	void encodeValue(JsonStream& out, const std::vector<T>& value);
+
+	// النموذج قد لا يستخدم كل الأنواع الأساسية
+	[[maybe_unused]] bool decodeValue(json& value, std::string& out) {
+		if (!value.is_string()) {
+			return false;
+		}
+		out = std::move(value.get_ref<std::string&>());
+		return true;
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, int32_t& out) {
+		if (!value.is_number_integer()) {
+			return false;
+		}
+		if (value.is_number_unsigned()) {
+			uint64_t number = value.get<uint64_t>();
+			out = static_cast<int32_t>(number);
+			return number <= static_cast<uint64_t>(std::numeric_limits<int32_t>::max());
+		}
+		int64_t number = value.get<int64_t>();
+		out = static_cast<int32_t>(number);
+		return number >= std::numeric_limits<int32_t>::min() && number <= std::numeric_limits<int32_t>::max();
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, uint32_t& out) {
+		if (!value.is_number_integer()) {
+			return false;
+		}
+		// الأعداد غير السالبة تُحلل بلا إشارة، لكن json المبني برمجياً قد يحملها بإشارة
+		if (!value.is_number_unsigned() && value.get<int64_t>() < 0) {
+			return false;
+		}
+		uint64_t number = value.get<uint64_t>();
+		out = static_cast<uint32_t>(number);
+		return number <= std::numeric_limits<uint32_t>::max();
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, double& out) {
+		if (!value.is_number()) {
+			return false;
+		}
+		out = value.get<double>();
+		return true;
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, bool& out) {
+		if (!value.is_boolean()) {
+			return false;
+		}
+		out = value.get<bool>();
+		return true;
+	}
+
+	[[maybe_unused]] bool decodeValue(json& value, json& out) {
+		out = std::move(value);
+		return true;
+	}
+
+	template <typename T>
+	std::enable_if_t<std::is_enum_v<T>, bool> decodeValue(json& value, T& out) {
+		std::underlying_type_t<T> number;
+		if (!decodeValue(value, number)) {
+			return false;
+		}
+		out = static_cast<T>(number);
+		return true;
+	}
+
+	template <typename T>
+	std::enable_if_t<std::is_class_v<T>, bool> decodeValue(json& value, T& out) {
+		return decode(value, out);
+	}
+
+	template <typename T>
+	[[maybe_unused]] bool decodeValue(json& value, std::optional<T>& out) {
+		if (value.is_null()) {
+			out.reset();
+			return true;
+		}
+		return decodeValue(value, out.emplace());
+	}
+
+	template <typename T>
+	[[maybe_unused]] bool decodeValue(json& value, std::vector<T>& out) {
+		if (!value.is_array()) {
+			return false;
+		}
+		out.clear();
+		out.reserve(value.size());
+		for (json& element : value) {
+			if (!decodeValue(element, out.emplace_back())) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, const std::string& value) {
+		out.value(value);
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, int32_t value) {
+		out.value(static_cast<int64_t>(value));
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, uint32_t value) {
+		out.value(static_cast<uint64_t>(value));
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, double value) {
+		out.value(json(value));
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, bool value) {
+		out.value(value);
+	}
+
+	[[maybe_unused]] void encodeValue(JsonStream& out, const json& value) {
+		out.value(value);
+	}
+
+	template <typename T>
+	std::enable_if_t<std::is_enum_v<T>, void> encodeValue(JsonStream& out, T value) {
+		encodeValue(out, static_cast<std::underlying_type_t<T>>(value));
+	}
+
+	template <typename T>
+	std::enable_if_t<std::is_class_v<T>, void> encodeValue(JsonStream& out, const T& value) {
+		encode(out, value);
+	}
+
+	template <typename T>
+	void encodeValue(JsonStream& out, const std::optional<T>& value) {
+		if (value) {
+			encodeValue(out, *value);
+		}
+		else {
+			out.value(nullptr);
+		}
+	}
+
+	template <typename T>
+	void encodeValue(JsonStream& out, const std::vector<T>& value) {
+		out.beginArray();
+		for (const T& element : value) {
+			encodeValue(out, element);
+		}
+		out.endArray();
+	}
+}
+)";
+
+	for (const std::string& name : sorted) {
+		const Structure& structure = generated[name];
+
+		uint64_t required = 0;
+		for (size_t i = 0; i < structure.properties.size(); ++i) {
+			if (!structure.properties[i].optional) {
+				required |= uint64_t(1) << i;
+			}
+		}
+
+		out << "\nbool decode(json& value, " << name << "& out) {\n"
+			<< "\tif (!value.is_object()) {\n"
+			<< "\t\treturn false;\n"
+			<< "\t}\n";
+		if (required != 0) {
+			out << "\tuint64_t seen = 0;\n";
+		}
+		if (!structure.properties.empty()) {
+			out << "\tfor (auto member = value.begin(); member != value.end(); ++member) {\n"
+				<< "\t\tconst std::string& key = member.key();\n";
+			for (size_t i = 0; i < structure.properties.size(); ++i) {
+				const Property& property = structure.properties[i];
+				std::string condition = "!decodeValue(*member, out." + property.field + ")";
+				if (!property.type.check.empty()) {
+					std::string check = property.type.check;
+					if (property.optional || property.type.nullable) {
+						check = "member->is_null() || " + check;
+					}
+					condition = "!(" + check + ") || " + condition;
+				}
+				out << "\t\t" << (i > 0 ? "else if" : "if") << " (key == \"" << property.name << "\") {\n"
+					<< "\t\t\tif (" << condition << ") {\n"
+					<< "\t\t\t\treturn false;\n"
+					<< "\t\t\t}\n";
+				if (!property.optional) {
+					out << "\t\t\tseen |= uint64_t(1) << " << i << ";\n";
+				}
+				out << "\t\t}\n";
+			}
+			out << "\t}\n";
+		}
+		if (required != 0) {
+			std::ostringstream mask;
+			mask << "0x" << std::hex << required;
+			out << "\treturn (seen & " << mask.str() << ") == " << mask.str() << ";\n";
+		}
+		else {
+			out << "\treturn true;\n";
+		}
+		out << "}\n";
+
+		// نفس ترتيب المفاتيح الذي ينتجه تسلسل json
+		std::vector<const Property*> byName;
+		for (const Property& property : structure.properties) {
+			byName.push_back(&property);
+		}
+		std::sort(byName.begin(), byName.end(), [](const Property* a, const Property* b) { return a->name < b->name; });
+
+		out << "\nvoid encode(JsonStream& out, const " << name << "& value) {\n"
+			<< "\tout.beginObject();\n";
+		for (const Property* property : byName) {
+			if (property->optional) {
+				out << "\tif (value." << property->field << ") {\n"
+					<< "\t\tout.key(\"" << property->name << "\");\n"
+					<< "\t\tencodeValue(out, *value." << property->field << ");\n"
+					<< "\t}\n";
+			}
+			else {
+				out << "\tout.key(\"" << property->name << "\");\n"
+					<< "\tencodeValue(out, value." << property->field << ");\n";
+			}
+		}
+		out << "\tout.endObject();\n"
+			<< "}\n";
+	}
+	out << "}\n";
+}
+
+int main(int argc, char* argv[]) {
+	if (argc != 4) {
+		std::fprintf(stderr, "Usage: %s <metaModel.json> <Protocol.h> <Protocol.cpp>\n", argv[0]);
+		return 2;
+	}
+
+	std::ifstream input(argv[1]);
+	Model model = Model::parse(input, nullptr, false);
+	if (model.is_discarded()) {
+		std::fprintf(stderr, "Cannot parse %s\n", argv[1]);
+		return 1;
+	}
+
+	std::ostringstream header;
+	std::ostringstream source;
+	Generator generator(model);
+	if (!generator.run(header, source)) {
+		return 1;
+	}
+
+	std::ofstream(argv[2], std::ios::binary) << header.str();
+	std::ofstream(argv[3], std::ios::binary) << source.str();
+	return 0;
+}
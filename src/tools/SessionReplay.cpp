@@ -0,0 +1,332 @@
+// إعادة تشغيل جلسة مسجلة عبر --record: يشغّل الخادم ويرسل إليه الرسائل الواردة
+// بتوقيتها الأصلي أو بأقصى سرعة، ويطابق الردود مع طلباتها لقياس زمن الاستجابة
+// لكل طريقة (p50/p90/p99)
+
+#include "MessageReader.h"
+#include "SessionRecorder.h"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	// مهلة انتظار الردود المتبقية بعد إرسال آخر رسالة
+	constexpr auto RESPONSE_TIMEOUT = std::chrono::seconds(30);
+
+	struct Options {
+		bool maxSpeed = false;
+		bool serverLog = false;
+		std::string recording;
+		std::vector<std::string> command{ "./alif-lsp" };
+	};
+
+	// طلب أُرسل ولم يصل رده بعد
+	struct PendingRequest {
+		std::string method;
+		Clock::time_point sentAt;
+	};
+
+	// حالة مشتركة بين خيط الإرسال وخيط قراءة الردود
+	struct ReplayState {
+		std::mutex mutex;
+		std::condition_variable answered;
+		std::unordered_map<std::string, PendingRequest> pending;
+		std::map<std::string, std::vector<double>> latencies;  // ميلي ثانية لكل طريقة
+		size_t responses = 0;
+		size_t notifications = 0;
+		size_t unmatched = 0;
+		bool closed = false;
+	};
+
+	void printUsage() {
+		std::fprintf(stderr,
+			"Usage: alif-lsp-replay [--max-speed] [--server-log] <recording> [-- <server command>...]\n"
+			"Replays the inbound messages of a --record session (default server: ./alif-lsp)\n");
+	}
+
+	bool parseArguments(int argc, char* argv[], Options& options) {
+		int i = 1;
+		for (; i < argc; ++i) {
+			std::string arg = argv[i];
+			if (arg == "--max-speed") {
+				options.maxSpeed = true;
+			}
+			else if (arg == "--server-log") {
+				options.serverLog = true;
+			}
+			else if (arg == "--") {
+				++i;
+				break;
+			}
+			else if (options.recording.empty() && arg.rfind("--", 0) != 0) {
+				options.recording = arg;
+			}
+			else {
+				return false;
+			}
+		}
+		if (i < argc) {
+			options.command.assign(argv + i, argv + argc);
+		}
+		return !options.recording.empty();
+	}
+
+	bool loadRecording(const std::string& path, std::vector<SessionRecorder::Entry>& inbound) {
+		std::FILE* file = std::fopen(path.c_str(), "rb");
+		if (!file) {
+			std::fprintf(stderr, "Cannot open %s: %s\n", path.c_str(), std::strerror(errno));
+			return false;
+		}
+		SessionRecorder::Entry entry;
+		while (SessionRecorder::readEntry(file, entry)) {
+			if (entry.direction == RecordDirection::INBOUND) {
+				inbound.push_back(std::move(entry));
+			}
+		}
+		bool complete = std::feof(file) != 0;
+		std::fclose(file);
+		if (!complete) {
+			std::fprintf(stderr, "Recording is truncated after %zu inbound messages\n", inbound.size());
+		}
+		return true;
+	}
+
+	// تشغيل الخادم مع أنبوبين لـ stdin/stdout
+	pid_t startServer(const Options& options, int& toServer, int& fromServer) {
+		int input[2];
+		int output[2];
+		if (pipe(input) < 0 || pipe(output) < 0) {
+			std::perror("pipe");
+			return -1;
+		}
+
+		pid_t pid = fork();
+		if (pid == 0) {
+			dup2(input[0], 0);
+			dup2(output[1], 1);
+			if (!options.serverLog) {
+				int null = open("/dev/null", O_WRONLY);
+				dup2(null, 2);
+			}
+			close(input[0]);
+			close(input[1]);
+			close(output[0]);
+			close(output[1]);
+
+			std::vector<char*> args;
+			for (const std::string& arg : options.command) {
+				args.push_back(const_cast<char*>(arg.c_str()));
+			}
+			args.push_back(nullptr);
+			execvp(args[0], args.data());
+			std::perror("exec");
+			_exit(127);
+		}
+
+		close(input[0]);
+		close(output[1]);
+		toServer = input[1];
+		fromServer = output[0];
+		return pid;
+	}
+
+	bool writeAll(int fd, const char* data, size_t size) {
+		while (size > 0) {
+			ssize_t written = write(fd, data, size);
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			data += written;
+			size -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+	// تسجيل وقت إرسال الطلبات في الرسالة (أو في عناصر الدفعة)
+	void trackRequests(ReplayState& state, const json& message, Clock::time_point sentAt) {
+		if (message.is_array()) {
+			for (const json& element : message) {
+				trackRequests(state, element, sentAt);
+			}
+			return;
+		}
+		if (!message.is_object() || !message.contains("method")) {
+			return;
+		}
+		if (!message.contains("id")) {
+			++state.notifications;
+			return;
+		}
+		state.pending[message["id"].dump()] = { message["method"].get<std::string>(), sentAt };
+	}
+
+	void matchResponse(ReplayState& state, const json& message, Clock::time_point receivedAt) {
+		if (message.is_array()) {
+			for (const json& element : message) {
+				matchResponse(state, element, receivedAt);
+			}
+			return;
+		}
+		// طلبات الخادم وإشعاراته للمحرر (مثل التشخيصات) ليست ردوداً
+		if (!message.is_object() || message.contains("method") || !message.contains("id")) {
+			return;
+		}
+		++state.responses;
+		auto it = state.pending.find(message["id"].dump());
+		if (it == state.pending.end()) {
+			++state.unmatched;
+			return;
+		}
+		state.latencies[it->second.method].push_back(
+			std::chrono::duration<double, std::milli>(receivedAt - it->second.sentAt).count());
+		state.pending.erase(it);
+	}
+
+	void readResponses(int fd, ReplayState& state) {
+		MessageReader reader(fd);
+		MessageBody body;
+		while (reader.read(body) == ReadStatus::MESSAGE) {
+			Clock::time_point receivedAt = Clock::now();
+			json message;
+			try {
+				message = body.chunked ? json::parse(body.chunks.begin(), body.chunks.end())
+					: json::parse(body.data.data(), body.data.data() + body.data.size());
+			}
+			catch (const json::parse_error&) {
+				continue;
+			}
+			std::lock_guard<std::mutex> lock(state.mutex);
+			matchResponse(state, message, receivedAt);
+			state.answered.notify_all();
+		}
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.closed = true;
+		state.answered.notify_all();
+	}
+
+	// النسبة المئوية بطريقة أقرب رتبة على قيم مرتبة
+	double percentile(const std::vector<double>& sorted, double p) {
+		size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.999999);
+		return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+	}
+
+	void report(ReplayState& state, size_t sent, double seconds) {
+		std::printf("%zu messages replayed in %.3f s (%.0f msgs/s), %zu responses, %zu notifications\n\n",
+			sent, seconds, static_cast<double>(sent) / seconds, state.responses, state.notifications);
+		std::printf("%-36s %8s %10s %10s %10s %10s\n", "method", "count", "p50 ms", "p90 ms", "p99 ms", "max ms");
+		for (auto& [method, values] : state.latencies) {
+			std::sort(values.begin(), values.end());
+			std::printf("%-36s %8zu %10.3f %10.3f %10.3f %10.3f\n", method.c_str(), values.size(),
+				percentile(values, 50), percentile(values, 90), percentile(values, 99), values.back());
+		}
+
+		if (!state.pending.empty()) {
+			std::map<std::string, size_t> missing;
+			for (const auto& [id, request] : state.pending) {
+				++missing[request.method];
+			}
+			std::printf("\nUnanswered requests:\n");
+			for (const auto& [method, count] : missing) {
+				std::printf("%-36s %8zu\n", method.c_str(), count);
+			}
+		}
+		if (state.unmatched > 0) {
+			std::printf("\n%zu responses did not match a replayed request\n", state.unmatched);
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	if (!parseArguments(argc, argv, options)) {
+		printUsage();
+		return 2;
+	}
+
+	std::vector<SessionRecorder::Entry> inbound;
+	if (!loadRecording(options.recording, inbound)) {
+		return 1;
+	}
+	if (inbound.empty()) {
+		std::fprintf(stderr, "No inbound messages in %s\n", options.recording.c_str());
+		return 1;
+	}
+
+	std::signal(SIGPIPE, SIG_IGN);
+	int toServer = -1;
+	int fromServer = -1;
+	pid_t server = startServer(options, toServer, fromServer);
+	if (server < 0) {
+		return 1;
+	}
+
+	ReplayState state;
+	std::thread reader(readResponses, fromServer, std::ref(state));
+
+	// التوقيت الأصلي: كل رسالة تُرسل بنفس فارقها عن أول رسالة في التسجيل
+	Clock::time_point start = Clock::now();
+	int64_t firstTimestamp = inbound.front().timestamp;
+	size_t sent = 0;
+	for (const SessionRecorder::Entry& entry : inbound) {
+		if (!options.maxSpeed) {
+			std::this_thread::sleep_until(start + std::chrono::microseconds(entry.timestamp - firstTimestamp));
+		}
+
+		json message = json::parse(entry.body, nullptr, false);
+		{
+			std::lock_guard<std::mutex> lock(state.mutex);
+			if (!message.is_discarded()) {
+				trackRequests(state, message, Clock::now());
+			}
+		}
+
+		std::string frame = "Content-Length: " + std::to_string(entry.body.size()) + "\r\n\r\n";
+		frame += entry.body;
+		if (!writeAll(toServer, frame.data(), frame.size())) {
+			std::fprintf(stderr, "Server closed its input after %zu messages\n", sent);
+			break;
+		}
+		++sent;
+	}
+
+	// انتظار بقية الردود ثم إغلاق الإدخال إن لم يتضمن التسجيل exit
+	{
+		std::unique_lock<std::mutex> lock(state.mutex);
+		state.answered.wait_for(lock, RESPONSE_TIMEOUT, [&state] { return state.pending.empty() || state.closed; });
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	close(toServer);
+	reader.join();
+	close(fromServer);
+
+	int status = 0;
+	waitpid(server, &status, 0);
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+	report(state, sent, seconds);
+	if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+		std::printf("\nServer exited with status %d\n", WEXITSTATUS(status));
+	}
+	return state.pending.empty() ? 0 : 1;
+}